@@ -13,41 +13,11 @@
 #include <iostream>
 #include <vector>
 #include <string>
-#include <sstream>
 #include "processing/hilbert_transform.h"
 #include "stream/csv_streamer.h"
+#include "stream/streamer_factory.h"
 #include <filesystem> 
-
-std::vector<double> read_csv_data(std::ifstream &input_stream)
-{
-    std::vector<double> data;
-    std::string line;
-
-    // Skip the header line if it exists
-    std::getline(input_stream, line);
-
-    while (std::getline(input_stream, line))
-    {
-        std::stringstream ss(line);
-        std::string value;
-
-        // Assuming the data is in the first column
-        if (std::getline(ss, value, ','))
-        {
-            try
-            {
-                data.push_back(std::stod(value));
-            }
-            catch (const std::exception &e)
-            {
-                std::cerr << "Error parsing value: " << value << "\n"
-                          << e.what() << std::endl;
-            }
-        }
-    }
-
-    return data;
-}
+#include <memory>
 
 int main()
 {
@@ -65,6 +35,7 @@ int main()
     input_csv_streamer.set_name(input_csv_path);
     input_csv_streamer.set_data_type("double");
     input_csv_streamer.set_num_channels(1); // Assuming single-channel ECG data
+    input_csv_streamer.set_input_column(0); // The ECG samples are in the first column
 
     // Open the input CSV file
     if (!input_csv_streamer.open_input_stream())
@@ -73,8 +44,14 @@ int main()
         return 1;
     }
 
-    // Read data from CSV
-    std::vector<double> csv_data = read_csv_data(input_csv_streamer.input);
+    // Read data from CSV, a chunk at a time into the same buffer
+    std::vector<double> csv_data;
+    std::vector<double> chunk(4096);
+    std::size_t received;
+    while ((received = input_csv_streamer.receive(chunk)) != 0)
+    {
+        csv_data.insert(csv_data.end(), chunk.begin(), chunk.begin() + received);
+    }
 
     // Process with Hilbert Transform
     HilbertTransform hilbert(csv_data.size());
@@ -96,10 +73,25 @@ int main()
 
     // Write data to the output CSV file
     std::cout << "Writing results to " << output_csv_path << std::endl;
+    std::vector<double> frames(csv_data.size() * 2);
     for (size_t i = 0; i < csv_data.size(); ++i)
     {
-        std::vector<double> data = {csv_data[i], hilbert_result[i]};
-        output_csv_streamer.publish(std::vector<VarTag>(data.size(), VarTag::DOUBLE), &data);
+        frames[2 * i] = csv_data[i];
+        frames[2 * i + 1] = hilbert_result[i];
+    }
+    output_csv_streamer.publish(frames);
+
+    // Record the same frames in the binary format as well
+    const std::string output_bin_path = cwd + "/cli/data/ecg_data_with_hilbert.bin";
+    StreamerFactory factory;
+    std::unique_ptr<StreamerInterface> output_bin_streamer(factory.get_streamer("BIN"));
+    output_bin_streamer->set_name(output_bin_path);
+    output_bin_streamer->set_data_type("double");
+    output_bin_streamer->set_num_channels(2);
+    if (!output_bin_streamer->open_output_stream() || !output_bin_streamer->publish(frames))
+    {
+        std::cerr << "Failed to write output BIN file: " << output_bin_path << std::endl;
+        return 1;
     }
 
     std::cout << "Processing complete. Results written to " << output_csv_path << std::endl;
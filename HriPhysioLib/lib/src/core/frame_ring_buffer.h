@@ -0,0 +1,469 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Trushar Ghanekar,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Trushar Ghanekar <trushar.ghanekar@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+
+#ifndef HRI_PHYSIO_FRAME_RING_BUFFER_H
+#define HRI_PHYSIO_FRAME_RING_BUFFER_H
+
+#include <memory>
+#include <mutex>
+#include "ring_copy.h"
+#include "ring_span.h"
+
+/**
+ * @class FrameRingBuffer
+ * @brief Thread-safe ring buffer of multichannel frames.
+ *
+ * A frame holds one sample per channel. Items are only ever added and
+ * removed as whole frames, so interleaved data can never fall out of
+ * alignment. Samples are stored per channel (structure of arrays), so a
+ * channel can be read as contiguous memory; interleaved input is split into
+ * channels once on enqueue. Like RingBuffer, a full buffer overwrites its
+ * oldest frames.
+ * @tparam T
+ */
+template <class T>
+class FrameRingBuffer
+{
+    /**
+     * Unique pointer to the sample array, one block of buffer_length per channel.
+     */
+    std::unique_ptr<T[]> buffer;
+
+    /**
+     * Number of channels per frame.
+     */
+    std::size_t num_channels;
+
+    /**
+     * Total length of the buffer in frames.
+     */
+    std::size_t buffer_length;
+
+    /**
+     * Frame index of the head of the buffer.
+     */
+    std::size_t buffer_head;
+
+    /**
+     * Frame index of the tail of the buffer.
+     */
+    std::size_t buffer_tail;
+
+    /**
+     * Current number of frames in the buffer.
+     */
+    std::size_t buffer_size;
+
+    /**
+     * Mutex for thread safety.
+     */
+    std::mutex lock;
+
+public:
+    /**
+     * @class View
+     * @brief Zero-copy per-channel view over the readable frames.
+     *
+     * The view holds the buffer lock for as long as it is alive. Keep it short-lived.
+     */
+    class View
+    {
+        /**
+         * Lock on the owning buffer.
+         */
+        std::unique_lock<std::mutex> guard;
+
+        /**
+         * Buffer this view reads from.
+         */
+        FrameRingBuffer *owner;
+
+    public:
+        /**
+         * Constructor to lock a buffer and view its readable frames.
+         * @param owner buffer to view.
+         */
+        explicit View(FrameRingBuffer *owner) : guard(owner->lock), owner(owner) {}
+
+        /**
+         * Get the readable samples of one channel.
+         * @param channel index of the channel.
+         * @return view over the samples, oldest first.
+         */
+        RingSpan<T> channel(const std::size_t channel) const
+        {
+            return owner->readable(channel);
+        }
+
+        /**
+         * Get the number of readable frames.
+         * @return number of frames.
+         */
+        [[nodiscard]] std::size_t size() const
+        {
+            return owner->buffer_size;
+        }
+
+        /**
+         * Remove frames from the front of the buffer.
+         * @param frames number of frames to remove.
+         * @return true if successful, false otherwise.
+         */
+        bool consume(const std::size_t frames)
+        {
+            return owner->discard(frames);
+        }
+    };
+
+    /**
+     * Constructor to initialize the buffer with a channel count and a length.
+     * @param channels number of channels per frame.
+     * @param length buffer length in frames.
+     */
+    explicit FrameRingBuffer(const std::size_t channels = 1, const std::size_t length = 0) : num_channels(channels),
+                                                                                          buffer_length(length),
+                                                                                          buffer_head(0),
+                                                                                          buffer_tail(0),
+                                                                                          buffer_size(0)
+    {
+        buffer_init();
+    }
+
+    /**
+     * Deconstructor to clean up the buffer.
+     */
+    ~FrameRingBuffer()
+    {
+        buffer.reset();
+    }
+
+    /**
+     * Enqueue interleaved frames (ch0, ch1, ..., ch0, ch1, ...).
+     * @param items interleaved samples, frames * channels() long.
+     * @param frames number of frames to enqueue.
+     * @return true if successful, false otherwise.
+     */
+    bool enqueue(const T *items, const std::size_t frames)
+    {
+        lock.lock();
+
+        if (frames > buffer_length || buffer_length == 0 || num_channels == 0)
+        {
+            lock.unlock();
+            return false;
+        }
+
+        for (std::size_t ch = 0; ch < num_channels; ++ch)
+        {
+            T *block = channel_block(ch);
+            std::size_t position = buffer_tail;
+            const T *source = items + ch;
+            for (std::size_t idx = 0; idx < frames; ++idx)
+            {
+                block[position] = *source;
+                source += num_channels;
+                position = advance(position, 1);
+            }
+        }
+
+        commit(frames);
+
+        lock.unlock();
+        return true;
+    }
+
+    /**
+     * Enqueue frames given as one array per channel.
+     * @param channels one pointer per channel, each frames long.
+     * @param frames number of frames to enqueue.
+     * @return true if successful, false otherwise.
+     */
+    bool enqueue_planar(const T *const *channels, const std::size_t frames)
+    {
+        lock.lock();
+
+        if (frames > buffer_length || buffer_length == 0 || num_channels == 0)
+        {
+            lock.unlock();
+            return false;
+        }
+
+        for (std::size_t ch = 0; ch < num_channels; ++ch)
+        {
+            ring_write(channel_block(ch), buffer_length, buffer_tail, channels[ch], frames);
+        }
+
+        commit(frames);
+
+        lock.unlock();
+        return true;
+    }
+
+    /**
+     * Dequeue interleaved frames with optional overlap.
+     * @param items destination for frames * channels() interleaved samples.
+     * @param frames number of frames to dequeue.
+     * @param overlap number of frames to leave in the buffer.
+     * @return true if successful, false otherwise.
+     */
+    bool dequeue(T *items, const std::size_t frames, const std::size_t overlap = 0)
+    {
+        lock.lock();
+
+        if (!readable_frames(frames, overlap))
+        {
+            lock.unlock();
+            return false;
+        }
+
+        for (std::size_t ch = 0; ch < num_channels; ++ch)
+        {
+            const T *block = channel_block(ch);
+            std::size_t position = buffer_head;
+            T *target = items + ch;
+            for (std::size_t idx = 0; idx < frames; ++idx)
+            {
+                *target = block[position];
+                target += num_channels;
+                position = advance(position, 1);
+            }
+        }
+
+        discard(frames - overlap);
+
+        lock.unlock();
+        return true;
+    }
+
+    /**
+     * Dequeue frames into one contiguous array per channel, with optional overlap.
+     * @param items destination laid out channel by channel, frames * channels() long.
+     * @param frames number of frames to dequeue.
+     * @param overlap number of frames to leave in the buffer.
+     * @return true if successful, false otherwise.
+     */
+    bool dequeue_planar(T *items, const std::size_t frames, const std::size_t overlap = 0)
+    {
+        lock.lock();
+
+        if (!readable_frames(frames, overlap))
+        {
+            lock.unlock();
+            return false;
+        }
+
+        for (std::size_t ch = 0; ch < num_channels; ++ch)
+        {
+            ring_read(channel_block(ch), buffer_length, buffer_head, items + ch * frames, frames);
+        }
+
+        discard(frames - overlap);
+
+        lock.unlock();
+        return true;
+    }
+
+    /**
+     * Get a per-channel view over all readable frames without copying them.
+     * The buffer stays locked until the returned view is destroyed.
+     * @return view over the readable frames.
+     */
+    View peek()
+    {
+        return View(this);
+    }
+
+    /**
+     * Check if the buffer is empty.
+     * @return true if empty, false otherwise.
+     */
+    bool empty()
+    {
+        return buffer_size == 0;
+    }
+
+    /**
+     * Check if the buffer is full.
+     * @return true if full, false otherwise.
+     */
+    bool full()
+    {
+        return buffer_size >= buffer_length;
+    }
+
+    /**
+     * Get the current number of frames in the buffer.
+     * @return current number of frames.
+     */
+    std::size_t size()
+    {
+        return buffer_size;
+    }
+
+    /**
+     * Get the total length of the buffer in frames.
+     * @return total length of the buffer.
+     */
+    [[nodiscard]] std::size_t length() const
+    {
+        return buffer_length;
+    }
+
+    /**
+     * Get the number of channels per frame.
+     * @return number of channels.
+     */
+    [[nodiscard]] std::size_t channels() const
+    {
+        return num_channels;
+    }
+
+    /**
+     * Resize the buffer. Drops all buffered frames.
+     * @param channels new number of channels per frame.
+     * @param length new length of the buffer in frames.
+     */
+    void resize(const std::size_t channels, const std::size_t length)
+    {
+        lock.lock();
+
+        num_channels = channels;
+        buffer_length = length;
+        buffer_init();
+
+        lock.unlock();
+    }
+
+    /**
+     * Clear the buffer.
+     */
+    void clear()
+    {
+        lock.lock();
+
+        buffer_size = 0;
+        buffer_head = 0;
+        buffer_tail = 0;
+
+        lock.unlock();
+    }
+
+private:
+    /**
+     * Move a frame index forward around the buffer without a modulo.
+     * @param index index to move.
+     * @param count number of frames to move, at most buffer_length.
+     * @return the wrapped index.
+     */
+    [[nodiscard]] inline std::size_t advance(std::size_t index, const std::size_t count) const
+    {
+        index += count;
+        return (index >= buffer_length) ? index - buffer_length : index;
+    }
+
+    /**
+     * Get the storage block of a channel.
+     * @param channel index of the channel.
+     * @return pointer to buffer_length samples of that channel.
+     */
+    inline T *channel_block(const std::size_t channel)
+    {
+        return buffer.get() + channel * buffer_length;
+    }
+
+    /**
+     * Get the storage block of a channel.
+     * @param channel index of the channel.
+     * @return pointer to buffer_length samples of that channel.
+     */
+    inline const T *channel_block(const std::size_t channel) const
+    {
+        return buffer.get() + channel * buffer_length;
+    }
+
+    /**
+     * Check that a read of frames with overlap is possible. The caller must hold the lock.
+     * @param frames number of frames to read.
+     * @param overlap number of frames to leave in the buffer.
+     * @return true if enough frames are buffered.
+     */
+    [[nodiscard]] bool readable_frames(const std::size_t frames, const std::size_t overlap) const
+    {
+        return frames <= buffer_length && buffer_length != 0 && overlap <= frames && frames <= buffer_size;
+    }
+
+    /**
+     * Get the readable samples of one channel. The caller must hold the lock.
+     * @param channel index of the channel.
+     * @return view over the samples.
+     */
+    RingSpan<T> readable(const std::size_t channel) const
+    {
+        return make_ring_span<T>(channel_block(channel), buffer_length, buffer_head, buffer_size);
+    }
+
+    /**
+     * Publish frames that were just written at the tail. The caller must hold the lock.
+     * @param frames number of frames written.
+     */
+    void commit(const std::size_t frames)
+    {
+        buffer_tail = advance(buffer_tail, frames);
+
+        if (buffer_size + frames > buffer_length)
+        {
+            std::size_t dropped = buffer_size + frames - buffer_length;
+            buffer_head = advance(buffer_head, dropped);
+            buffer_size = buffer_length;
+        }
+        else
+        {
+            buffer_size += frames;
+        }
+    }
+
+    /**
+     * Remove frames from the front of the buffer. The caller must hold the lock.
+     * @param frames number of frames to remove.
+     * @return true if successful, false otherwise.
+     */
+    bool discard(const std::size_t frames)
+    {
+        if (frames > buffer_size)
+        {
+            return false;
+        }
+
+        buffer_head = advance(buffer_head, frames);
+        buffer_size -= frames;
+        return true;
+    }
+
+    /**
+     * Initialize the buffer for the current channel count and length.
+     */
+    void buffer_init()
+    {
+        buffer.reset(new T[num_channels * buffer_length]);
+
+        buffer_size = 0;
+        buffer_head = 0;
+        buffer_tail = 0;
+    }
+
+public:
+    // Disallow copy and assignment operators.
+    FrameRingBuffer(const FrameRingBuffer &) = delete;
+    FrameRingBuffer &operator=(const FrameRingBuffer &) = delete;
+};
+
+#endif // HRI_PHYSIO_FRAME_RING_BUFFER_H
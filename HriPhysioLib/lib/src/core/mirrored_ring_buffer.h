@@ -0,0 +1,473 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Trushar Ghanekar,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Trushar Ghanekar <trushar.ghanekar@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+
+#ifndef HRI_PHYSIO_MIRRORED_RING_BUFFER_H
+#define HRI_PHYSIO_MIRRORED_RING_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include "ring_copy.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @class MirroredRingBuffer
+ * @brief Thread-safe ring buffer whose readable region is always one contiguous array.
+ *
+ * On Linux, when the buffer size is a multiple of the page size, the same
+ * physical pages are mapped twice back-to-back (memfd_create + mmap), so any
+ * run of up to length() items starting anywhere in the ring is contiguous in
+ * virtual memory. Otherwise the buffer falls back to an array of twice the
+ * length in which every item is written to both halves. Either way, a window
+ * over the buffered samples can be handed straight to pocketfft without a
+ * copy. Like RingBuffer, a full buffer overwrites its oldest items.
+ * @tparam T trivially copyable item type.
+ */
+template <class T>
+class MirroredRingBuffer
+{
+    static_assert(std::is_trivially_copyable_v<T>, "MirroredRingBuffer requires a trivially copyable type");
+
+    /**
+     * Start of the storage, 2 * buffer_length items long.
+     */
+    T *buffer;
+
+    /**
+     * Storage for the fallback path, empty when the pages are mirrored.
+     */
+    std::unique_ptr<T[]> fallback;
+
+    /**
+     * Total length of the buffer.
+     */
+    std::size_t buffer_length;
+
+    /**
+     * Index of the head of the buffer.
+     */
+    std::size_t buffer_head;
+
+    /**
+     * Index of the tail of the buffer.
+     */
+    std::size_t buffer_tail;
+
+    /**
+     * Current size of the buffer.
+     */
+    std::size_t buffer_size;
+
+    /**
+     * Flag to indicate the storage is a double mapping of the same pages.
+     */
+    bool is_mirrored;
+
+    /**
+     * Mutex for thread safety.
+     */
+    std::mutex lock;
+
+public:
+    /**
+     * @class Window
+     * @brief Contiguous view over buffered items.
+     *
+     * The window holds the buffer lock for as long as it is alive, so
+     * producers cannot overwrite the samples being processed.
+     */
+    class Window
+    {
+        /**
+         * Lock on the owning buffer.
+         */
+        std::unique_lock<std::mutex> guard;
+
+        /**
+         * Buffer this window reads from.
+         */
+        MirroredRingBuffer *owner;
+
+    public:
+        /**
+         * Contiguous items in the window, oldest first.
+         */
+        std::span<const T> samples;
+
+        /**
+         * Constructor to lock a buffer before viewing a run of its items.
+         * @param owner buffer to view.
+         */
+        explicit Window(MirroredRingBuffer *owner) : guard(owner->lock), owner(owner) {}
+
+        /**
+         * Remove items from the front of the buffer. The window is emptied,
+         * since its samples may no longer be buffered.
+         * @param length number of items to remove.
+         * @return true if successful, false otherwise.
+         */
+        bool consume(const std::size_t length)
+        {
+            samples = {};
+            return owner->discard(length);
+        }
+    };
+
+    /**
+     * Constructor to initialize the ring buffer with a given length.
+     * @param length buffer length.
+     */
+    explicit MirroredRingBuffer(const std::size_t length = 0) : buffer(nullptr),
+                                                                buffer_length(0),
+                                                                buffer_head(0),
+                                                                buffer_tail(0),
+                                                                buffer_size(0),
+                                                                is_mirrored(false)
+    {
+        buffer_init(length);
+    }
+
+    /**
+     * Deconstructor to release the mapping or the fallback array.
+     */
+    ~MirroredRingBuffer()
+    {
+        buffer_release();
+    }
+
+    /**
+     * Enqueue a single item.
+     * @param item item to enqueue.
+     * @return true if successful, false otherwise.
+     */
+    bool enqueue(const T &item)
+    {
+        return enqueue(&item, 1);
+    }
+
+    /**
+     * Enqueue multiple items into the buffer. If there is not enough free
+     * space, the oldest items are overwritten.
+     * @param items items to enqueue.
+     * @param length number of items to enqueue.
+     * @return true if successful, false otherwise.
+     */
+    bool enqueue(const T *items, const std::size_t length)
+    {
+        lock.lock();
+
+        if (length > buffer_length || buffer_length == 0)
+        {
+            lock.unlock();
+            return false;
+        }
+
+        if (is_mirrored)
+        {
+            //-- The second mapping takes care of the wrap.
+            ring_copy(items, buffer + buffer_tail, length);
+        }
+        else
+        {
+            ring_write(buffer, buffer_length, buffer_tail, items, length);
+            ring_write(buffer + buffer_length, buffer_length, buffer_tail, items, length);
+        }
+
+        buffer_tail = advance(buffer_tail, length);
+
+        if (buffer_size + length > buffer_length)
+        {
+            std::size_t dropped = buffer_size + length - buffer_length;
+            buffer_head = advance(buffer_head, dropped);
+            buffer_size = buffer_length;
+        }
+        else
+        {
+            buffer_size += length;
+        }
+
+        lock.unlock();
+        return true;
+    }
+
+    /**
+     * Get a contiguous window over the newest items without copying them.
+     * The buffer stays locked until the returned window is destroyed.
+     * @param length number of items in the window.
+     * @return window over the items, empty if fewer items are buffered.
+     */
+    Window latest(const std::size_t length)
+    {
+        Window window(this);
+        if (length <= buffer_size)
+        {
+            window.samples = std::span<const T>(buffer + buffer_head + (buffer_size - length), length);
+        }
+        return window;
+    }
+
+    /**
+     * Get a contiguous window over the oldest items without copying them.
+     * The buffer stays locked until the returned window is destroyed.
+     * @param length number of items in the window.
+     * @return window over the items, empty if fewer items are buffered.
+     */
+    Window oldest(const std::size_t length)
+    {
+        Window window(this);
+        if (length <= buffer_size)
+        {
+            window.samples = std::span<const T>(buffer + buffer_head, length);
+        }
+        return window;
+    }
+
+    /**
+     * Get a contiguous window over all buffered items without copying them.
+     * The buffer stays locked until the returned window is destroyed.
+     * @return window over the items.
+     */
+    Window peek()
+    {
+        Window window(this);
+        window.samples = std::span<const T>(buffer + buffer_head, buffer_size);
+        return window;
+    }
+
+    /**
+     * Remove items from the front of the buffer without reading them.
+     * @param length number of items to remove.
+     * @return true if successful, false otherwise.
+     */
+    bool consume(const std::size_t length)
+    {
+        lock.lock();
+
+        bool ret = discard(length);
+
+        lock.unlock();
+        return ret;
+    }
+
+    /**
+     * Check if the storage is a double mapping rather than the double-write fallback.
+     * @return true if the pages are mirrored, false otherwise.
+     */
+    [[nodiscard]] bool mirrored() const
+    {
+        return is_mirrored;
+    }
+
+    /**
+     * Check if the buffer is empty.
+     * @return true if empty, false otherwise.
+     */
+    bool empty()
+    {
+        return buffer_size == 0;
+    }
+
+    /**
+     * Check if the buffer is full.
+     * @return true if full, false otherwise.
+     */
+    bool full()
+    {
+        return buffer_size >= buffer_length;
+    }
+
+    /**
+     * Get the current size of the buffer.
+     * @return current size of the buffer.
+     */
+    std::size_t size()
+    {
+        return buffer_size;
+    }
+
+    /**
+     * Get the total length of the buffer.
+     * @return total length of the buffer.
+     */
+    [[nodiscard]] std::size_t length() const
+    {
+        return buffer_length;
+    }
+
+    /**
+     * Resize the buffer to a new length. Drops all buffered items.
+     * @param length new length of the buffer.
+     */
+    void resize(const std::size_t length)
+    {
+        lock.lock();
+
+        buffer_release();
+        buffer_init(length);
+
+        lock.unlock();
+    }
+
+    /**
+     * Clear the buffer.
+     */
+    void clear()
+    {
+        lock.lock();
+
+        buffer_size = 0;
+        buffer_head = 0;
+        buffer_tail = 0;
+
+        lock.unlock();
+    }
+
+private:
+    /**
+     * Move an index forward around the buffer without a modulo.
+     * @param index index to move.
+     * @param count number of slots to move, at most buffer_length.
+     * @return the wrapped index.
+     */
+    [[nodiscard]] inline std::size_t advance(std::size_t index, const std::size_t count) const
+    {
+        index += count;
+        return (index >= buffer_length) ? index - buffer_length : index;
+    }
+
+    /**
+     * Remove items from the front of the buffer. The caller must hold the lock.
+     * @param length number of items to remove.
+     * @return true if successful, false otherwise.
+     */
+    bool discard(const std::size_t length)
+    {
+        if (length > buffer_size)
+        {
+            return false;
+        }
+
+        buffer_head = advance(buffer_head, length);
+        buffer_size -= length;
+        return true;
+    }
+
+    /**
+     * Try to map the same pages twice back-to-back.
+     * @param bytes size of one copy, a multiple of the page size.
+     * @return start of the double mapping, nullptr on failure.
+     */
+    static T *map_mirror(const std::size_t bytes)
+    {
+#ifdef __linux__
+        int fd = memfd_create("hri_physio_ring_buffer", MFD_CLOEXEC);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+
+        if (ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+        {
+            ::close(fd);
+            return nullptr;
+        }
+
+        //-- Reserve the full range first so both halves land next to each other.
+        void *base = mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED)
+        {
+            ::close(fd);
+            return nullptr;
+        }
+
+        auto *lower = static_cast<std::uint8_t *>(base);
+        void *first = mmap(lower, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+        void *second = mmap(lower + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+        ::close(fd);
+
+        if (first == MAP_FAILED || second == MAP_FAILED)
+        {
+            munmap(base, 2 * bytes);
+            return nullptr;
+        }
+
+        return static_cast<T *>(base);
+#else
+        return nullptr;
+#endif
+    }
+
+    /**
+     * Initialize the buffer with a given length.
+     * @param length length of the buffer.
+     */
+    void buffer_init(const std::size_t length)
+    {
+        buffer_length = length;
+        buffer_size = 0;
+        buffer_head = 0;
+        buffer_tail = 0;
+        is_mirrored = false;
+        buffer = nullptr;
+
+        if (length == 0)
+        {
+            return;
+        }
+
+#ifdef __linux__
+        const std::size_t bytes = length * sizeof(T);
+        const auto page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        if (bytes % page == 0)
+        {
+            buffer = map_mirror(bytes);
+            is_mirrored = (buffer != nullptr);
+        }
+#endif
+
+        if (!is_mirrored)
+        {
+            fallback.reset(new T[2 * length]);
+            buffer = fallback.get();
+        }
+    }
+
+    /**
+     * Release the mapping or the fallback array.
+     */
+    void buffer_release()
+    {
+#ifdef __linux__
+        if (is_mirrored)
+        {
+            munmap(buffer, 2 * buffer_length * sizeof(T));
+        }
+#endif
+        fallback.reset();
+        buffer = nullptr;
+        is_mirrored = false;
+    }
+
+public:
+    // Disallow copy and assignment operators.
+    MirroredRingBuffer(const MirroredRingBuffer &) = delete;
+    MirroredRingBuffer &operator=(const MirroredRingBuffer &) = delete;
+};
+
+#endif // HRI_PHYSIO_MIRRORED_RING_BUFFER_H
@@ -0,0 +1,321 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Trushar Ghanekar,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Trushar Ghanekar <trushar.ghanekar@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+
+#ifndef HRI_PHYSIO_MPMC_RING_BUFFER_H
+#define HRI_PHYSIO_MPMC_RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @class MpmcRingBuffer
+ * @brief Bounded lock-free queue for any number of producer and consumer threads.
+ *
+ * Follows Dmitry Vyukov's bounded MPMC queue: every slot carries a sequence
+ * number that tells producers and consumers whose turn it is, so the only
+ * shared writes are one compare-and-swap on the enqueue or dequeue position.
+ * Chunks are claimed in a single compare-and-swap as well, so the samples of
+ * one chunk (e.g. one LSL pull from one device) are never interleaved with
+ * another producer's. The capacity is rounded up to a power of two, and a
+ * full queue rejects new items rather than overwriting the oldest ones.
+ * @tparam T
+ */
+template <class T>
+class MpmcRingBuffer
+{
+    /**
+     * Size used to keep the shared positions on separate cache lines.
+     */
+    static constexpr std::size_t cache_line = 64;
+
+    /**
+     * @struct Cell
+     * @brief Slot of the queue with its turn counter.
+     */
+    struct Cell
+    {
+        /**
+         * Position this slot expects next: pos when free for the producer of
+         * pos, pos + 1 when holding the item for the consumer of pos.
+         */
+        std::atomic<std::size_t> sequence;
+
+        /**
+         * Stored item.
+         */
+        T data;
+    };
+
+    /**
+     * Unique pointer to the slot array.
+     */
+    std::unique_ptr<Cell[]> buffer;
+
+    /**
+     * Total length of the buffer, always a power of two (or zero).
+     */
+    std::size_t buffer_length;
+
+    /**
+     * Mask used to map a position onto a slot index.
+     */
+    std::size_t buffer_mask;
+
+    /**
+     * Next position to be claimed by a producer.
+     */
+    alignas(cache_line) std::atomic<std::size_t> enqueue_pos;
+
+    /**
+     * Next position to be claimed by a consumer.
+     */
+    alignas(cache_line) std::atomic<std::size_t> dequeue_pos;
+
+    /**
+     * Number of failed compare-and-swaps, i.e. times a thread lost a race for a position.
+     */
+    alignas(cache_line) std::atomic<std::uint64_t> contended;
+
+public:
+    /**
+     * Constructor to initialize the queue with a given length.
+     * @param length minimum queue length, rounded up to a power of two.
+     */
+    explicit MpmcRingBuffer(const std::size_t length = 0) : buffer_length(0),
+                                                            buffer_mask(0),
+                                                            enqueue_pos(0),
+                                                            dequeue_pos(0),
+                                                            contended(0)
+    {
+        buffer_init(length);
+    }
+
+    /**
+     * Deconstructor to clean up the buffer.
+     */
+    ~MpmcRingBuffer()
+    {
+        buffer.reset();
+    }
+
+    /**
+     * Enqueue a single item.
+     * @param item item to enqueue.
+     * @return true if successful, false if the queue is full.
+     */
+    bool enqueue(const T &item)
+    {
+        return enqueue(&item, 1);
+    }
+
+    /**
+     * Enqueue a chunk of items in consecutive positions. Either the whole
+     * chunk is enqueued or none of it is.
+     * @param items items to enqueue.
+     * @param length number of items to enqueue.
+     * @return true if successful, false if there is not enough free space.
+     */
+    bool enqueue(const T *items, const std::size_t length)
+    {
+        if (length == 0 || length > buffer_length)
+        {
+            return false;
+        }
+
+        std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            const int state = claimable(pos, length, 0);
+            if (state < 0)
+            {
+                return false;
+            }
+
+            if (state == 0)
+            {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + length, std::memory_order_relaxed))
+                {
+                    break;
+                }
+                contended.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        for (std::size_t idx = 0; idx < length; ++idx)
+        {
+            Cell &cell = buffer[(pos + idx) & buffer_mask];
+            cell.data = items[idx];
+            cell.sequence.store(pos + idx + 1, std::memory_order_release);
+        }
+        return true;
+    }
+
+    /**
+     * Dequeue a single item.
+     * @param item item to dequeue.
+     * @return true if successful, false if the queue is empty.
+     */
+    bool dequeue(T &item)
+    {
+        return dequeue(&item, 1);
+    }
+
+    /**
+     * Dequeue a run of items from consecutive positions. Either the whole
+     * run is dequeued or none of it is.
+     * @param items destination for the items.
+     * @param length number of items to dequeue.
+     * @return true if successful, false if fewer items are ready.
+     */
+    bool dequeue(T *items, const std::size_t length)
+    {
+        if (length == 0 || length > buffer_length)
+        {
+            return false;
+        }
+
+        std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            const int state = claimable(pos, length, 1);
+            if (state < 0)
+            {
+                return false;
+            }
+
+            if (state == 0)
+            {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + length, std::memory_order_relaxed))
+                {
+                    break;
+                }
+                contended.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        for (std::size_t idx = 0; idx < length; ++idx)
+        {
+            Cell &cell = buffer[(pos + idx) & buffer_mask];
+            items[idx] = cell.data;
+            cell.sequence.store(pos + idx + buffer_length, std::memory_order_release);
+        }
+        return true;
+    }
+
+    /**
+     * Get an approximate count of the items in the queue.
+     * @return number of claimed but not yet dequeued positions.
+     */
+    [[nodiscard]] std::size_t size() const
+    {
+        const std::size_t head = dequeue_pos.load(std::memory_order_relaxed);
+        const std::size_t tail = enqueue_pos.load(std::memory_order_relaxed);
+        return (tail > head) ? tail - head : 0;
+    }
+
+    /**
+     * Check if the queue is (approximately) empty.
+     * @return true if empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * Get the total length of the queue.
+     * @return total length of the queue.
+     */
+    [[nodiscard]] std::size_t length() const
+    {
+        return buffer_length;
+    }
+
+    /**
+     * Get the number of times a thread lost a race for a position.
+     * @return number of failed compare-and-swaps so far.
+     */
+    [[nodiscard]] std::uint64_t contention() const
+    {
+        return contended.load(std::memory_order_relaxed);
+    }
+
+private:
+    /**
+     * Check whether a run of positions is ready to be claimed.
+     * @param pos first position of the run.
+     * @param length number of positions.
+     * @param lag 0 when claiming for a producer, 1 when claiming for a consumer.
+     * @return 0 if every slot is ready, -1 if the queue is full (producer) or
+     *     not filled yet (consumer), 1 if pos is stale and must be reloaded.
+     */
+    int claimable(const std::size_t pos, const std::size_t length, const std::size_t lag) const
+    {
+        //-- Check from the far end, which is the slot most likely to be busy.
+        for (std::size_t idx = length; idx-- > 0;)
+        {
+            const std::size_t expected = pos + idx + lag;
+            const std::size_t seq = buffer[(pos + idx) & buffer_mask].sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq - expected);
+            if (diff < 0)
+            {
+                return -1;
+            }
+            if (diff > 0)
+            {
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * Initialize the slots for a given length.
+     * @param length minimum length of the queue.
+     */
+    void buffer_init(const std::size_t length)
+    {
+        buffer_length = 0;
+        if (length != 0)
+        {
+            buffer_length = 1;
+            while (buffer_length < length)
+            {
+                buffer_length <<= 1;
+            }
+        }
+        buffer_mask = (buffer_length != 0) ? buffer_length - 1 : 0;
+
+        buffer.reset(new Cell[buffer_length]);
+        for (std::size_t idx = 0; idx < buffer_length; ++idx)
+        {
+            buffer[idx].sequence.store(idx, std::memory_order_relaxed);
+        }
+    }
+
+public:
+    // Disallow copy and assignment operators.
+    MpmcRingBuffer(const MpmcRingBuffer &) = delete;
+    MpmcRingBuffer &operator=(const MpmcRingBuffer &) = delete;
+};
+
+#endif // HRI_PHYSIO_MPMC_RING_BUFFER_H
@@ -25,8 +25,47 @@
 #ifndef HRI_PHYSIO_RING_BUFFER_H
 #define HRI_PHYSIO_RING_BUFFER_H
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <memory>
 #include <mutex>
+#include "ring_copy.h"
+#include "ring_span.h"
+
+/**
+ * @struct RingBufferStats
+ * @brief Snapshot of the instrumentation counters of a RingBuffer.
+ */
+struct RingBufferStats
+{
+    /**
+     * Total number of items enqueued.
+     */
+    std::size_t enqueued = 0;
+
+    /**
+     * Total number of items removed from the buffer by a read or a consume.
+     */
+    std::size_t dequeued = 0;
+
+    /**
+     * Number of items overwritten before they were read.
+     */
+    std::size_t dropped = 0;
+
+    /**
+     * Number of dequeues that failed because too few items were buffered.
+     */
+    std::size_t failed_dequeues = 0;
+
+    /**
+     * Largest number of items held at once.
+     */
+    std::size_t high_water_mark = 0;
+};
 
 /**
  * @class RingBuffer
@@ -66,7 +105,88 @@ class RingBuffer
      */
     std::mutex lock;
 
+    /**
+     * Condition variable signalled whenever new items are enqueued.
+     */
+    std::condition_variable data_ready;
+
+    /**
+     * Flag to enable the instrumentation counters. Only changed under the lock.
+     */
+    bool stats_enabled;
+
+    /**
+     * Counter of enqueued items, readable without the lock.
+     */
+    std::atomic<std::size_t> stat_enqueued;
+
+    /**
+     * Counter of items removed by reads, readable without the lock.
+     */
+    std::atomic<std::size_t> stat_dequeued;
+
+    /**
+     * Counter of items overwritten before being read, readable without the lock.
+     */
+    std::atomic<std::size_t> stat_dropped;
+
+    /**
+     * Counter of dequeues that found too few items, readable without the lock.
+     */
+    std::atomic<std::size_t> stat_failed_dequeues;
+
+    /**
+     * Largest size seen so far, readable without the lock.
+     */
+    std::atomic<std::size_t> stat_high_water_mark;
+
 public:
+    /**
+     * @class View
+     * @brief Zero-copy view over the readable region of a RingBuffer.
+     *
+     * The view holds the buffer lock for as long as it is alive, so producers
+     * block instead of overwriting the items being read. Keep it short-lived.
+     */
+    class View : public RingSpan<T>
+    {
+        /**
+         * Lock on the owning buffer.
+         */
+        std::unique_lock<std::mutex> guard;
+
+        /**
+         * Buffer this view reads from.
+         */
+        RingBuffer *owner;
+
+    public:
+        /**
+         * Constructor to lock a buffer and view its readable region.
+         * @param owner buffer to view.
+         */
+        explicit View(RingBuffer *owner) : guard(owner->lock), owner(owner)
+        {
+            static_cast<RingSpan<T> &>(*this) = owner->readable();
+        }
+
+        /**
+         * Remove items from the front of the buffer and shrink the view accordingly.
+         * @param length number of items to remove.
+         * @return true if successful, false otherwise.
+         */
+        bool consume(const std::size_t length)
+        {
+            if (!owner->discard(length))
+            {
+                return false;
+            }
+
+            static_cast<RingSpan<T> &>(*this) = owner->readable();
+            return true;
+        }
+    };
+
     /**
      * Constructor to initialize the ring buffer with a given length.
      * @param length buffer length.
@@ -74,7 +194,13 @@ public:
     explicit RingBuffer(const std::size_t length = 0) : buffer_length(length),
                                                         buffer_head(0),
                                                         buffer_tail(0),
-                                                        buffer_size(0)
+                                                        buffer_size(0),
+                                                        stats_enabled(false),
+                                                        stat_enqueued(0),
+                                                        stat_dequeued(0),
+                                                        stat_dropped(0),
+                                                        stat_failed_dequeues(0),
+                                                        stat_high_water_mark(0)
     {
         buffer_init(length);
     }
@@ -102,22 +228,27 @@ public:
             return false;
         }
 
+        std::size_t dropped = 0;
         if (full())
         {
-            buffer_head = (buffer_head + 1) % buffer_length;
+            buffer_head = advance(buffer_head, 1);
             --buffer_size;
+            dropped = 1;
         }
 
         buffer[buffer_tail] = item;
-        buffer_tail = (buffer_tail + 1) % buffer_length;
+        buffer_tail = advance(buffer_tail, 1);
         ++buffer_size;
+        record_enqueue(1, dropped);
 
         lock.unlock();
+        data_ready.notify_all();
         return true;
     }
 
     /**
-     * Enqueue multiple items into the buffer.
+     * Enqueue multiple items into the buffer. If there is not enough free
+     * space, the oldest items are overwritten.
      * @param items items to enqueue.
      * @param length number of items to enqueue.
      * @return true if successful, false otherwise.
@@ -132,20 +263,24 @@ public:
             return false;
         }
 
-        if (buffer_size + length >= buffer_length)
+        ring_write(buffer.get(), buffer_length, buffer_tail, items, length);
+        buffer_tail = advance(buffer_tail, length);
+
+        std::size_t dropped = 0;
+        if (buffer_size + length > buffer_length)
         {
-            buffer_head = (buffer_head + length) % buffer_length;
-            buffer_size -= length;
+            dropped = buffer_size + length - buffer_length;
+            buffer_head = advance(buffer_head, dropped);
+            buffer_size = buffer_length;
         }
-
-        for (std::size_t idx = 0; idx < length; ++idx)
+        else
         {
-            buffer[buffer_tail] = items[idx];
-            buffer_tail = (buffer_tail + 1) % buffer_length;
-            ++buffer_size;
+            buffer_size += length;
         }
+        record_enqueue(length, dropped);
 
         lock.unlock();
+        data_ready.notify_all();
         return true;
     }
 
@@ -166,13 +301,15 @@ public:
 
         if (empty())
         {
+            record_failed_dequeue();
             lock.unlock();
             return false;
         }
 
         item = buffer[buffer_head];
-        buffer_head = (buffer_head + 1) % buffer_length;
+        buffer_head = advance(buffer_head, 1);
         --buffer_size;
+        record_dequeue(1);
 
         lock.unlock();
         return true;
@@ -197,25 +334,45 @@ public:
 
         if (length > buffer_size)
         {
+            record_failed_dequeue();
             lock.unlock();
             return false;
         }
 
-        std::size_t keep = length - overlap;
-        std::size_t buffer_pos = buffer_head;
-        for (std::size_t idx = 0; idx < length; ++idx)
+        take(items, length, overlap);
+
+        lock.unlock();
+        return true;
+    }
+
+    /**
+     * Block until enough items are buffered, then dequeue them with optional overlap.
+     * @param items items to dequeue.
+     * @param length number of items to dequeue.
+     * @param overlap number of items to overlap.
+     * @param timeout maximum time to wait in seconds.
+     * @return true if successful, false on timeout or invalid arguments.
+     */
+    bool wait_dequeue(T *items, const std::size_t length, const std::size_t overlap, const double timeout)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+
+        if (length > buffer_length || buffer_length == 0 || overlap > length)
         {
-            items[idx] = buffer[buffer_pos];
-            buffer_pos = (buffer_pos + 1) % buffer_length;
+            return false;
+        }
 
-            if (idx < keep)
-            {
-                buffer_head = (buffer_head + 1) % buffer_length;
-                --buffer_size;
-            }
+        bool ready = data_ready.wait_for(guard, std::chrono::duration<double>(timeout), [this, length] {
+            return buffer_size >= length;
+        });
+
+        if (!ready)
+        {
+            record_failed_dequeue();
+            return false;
         }
 
-        lock.unlock();
+        take(items, length, overlap);
         return true;
     }
 
@@ -266,17 +423,77 @@ public:
             return false;
         }
 
-        std::size_t temp_head = buffer_head;
-        for (std::size_t idx = 0; idx < length; ++idx)
-        {
-            items[idx] = buffer[temp_head];
-            temp_head = (temp_head + 1) % buffer_length;
-        }
+        ring_read(buffer.get(), buffer_length, buffer_head, items, length);
 
         lock.unlock();
         return true;
     }
 
+    /**
+     * Get a view over all readable items without copying them.
+     * The buffer stays locked until the returned view is destroyed.
+     * @return view over the readable items.
+     */
+    View peek()
+    {
+        return View(this);
+    }
+
+    /**
+     * Remove items from the front of the buffer without reading them.
+     * @param length number of items to remove.
+     * @return true if successful, false otherwise.
+     */
+    bool consume(const std::size_t length)
+    {
+        lock.lock();
+
+        bool ret = discard(length);
+
+        lock.unlock();
+        return ret;
+    }
+
+    /**
+     * Enable or disable the instrumentation counters. Disabled by default.
+     * @param enable true to collect statistics.
+     */
+    void enable_stats(const bool enable)
+    {
+        lock.lock();
+
+        stats_enabled = enable;
+
+        lock.unlock();
+    }
+
+    /**
+     * Get a snapshot of the instrumentation counters without taking the lock.
+     * @return current statistics.
+     */
+    [[nodiscard]] RingBufferStats stats() const
+    {
+        RingBufferStats ret;
+        ret.enqueued = stat_enqueued.load(std::memory_order_relaxed);
+        ret.dequeued = stat_dequeued.load(std::memory_order_relaxed);
+        ret.dropped = stat_dropped.load(std::memory_order_relaxed);
+        ret.failed_dequeues = stat_failed_dequeues.load(std::memory_order_relaxed);
+        ret.high_water_mark = stat_high_water_mark.load(std::memory_order_relaxed);
+        return ret;
+    }
+
+    /**
+     * Reset all instrumentation counters to zero.
+     */
+    void reset_stats()
+    {
+        stat_enqueued.store(0, std::memory_order_relaxed);
+        stat_dequeued.store(0, std::memory_order_relaxed);
+        stat_dropped.store(0, std::memory_order_relaxed);
+        stat_failed_dequeues.store(0, std::memory_order_relaxed);
+        stat_high_water_mark.store(0, std::memory_order_relaxed);
+    }
+
     /**
      * Get a pointer to the buffer data.
      * @return pointer to the buffer data.
@@ -366,6 +583,104 @@ public:
     }
 
 private:
+    /**
+     * Move an index forward around the buffer without a modulo.
+     * @param index index to move.
+     * @param count number of slots to move, at most buffer_length.
+     * @return the wrapped index.
+     */
+    [[nodiscard]] inline std::size_t advance(std::size_t index, const std::size_t count) const
+    {
+        index += count;
+        return (index >= buffer_length) ? index - buffer_length : index;
+    }
+
+    /**
+     * Get the readable region. The caller must hold the lock.
+     * @return view over the readable items.
+     */
+    RingSpan<T> readable() const
+    {
+        return make_ring_span<T>(buffer.get(), buffer_length, buffer_head, buffer_size);
+    }
+
+    /**
+     * Copy items from the front of the buffer and remove all but the overlap.
+     * The caller must hold the lock and ensure enough items are buffered.
+     * @param items items to dequeue.
+     * @param length number of items to dequeue.
+     * @param overlap number of items to leave in the buffer.
+     */
+    void take(T *items, const std::size_t length, const std::size_t overlap)
+    {
+        std::size_t keep = length - overlap;
+        ring_read(buffer.get(), buffer_length, buffer_head, items, length);
+        buffer_head = advance(buffer_head, keep);
+        buffer_size -= keep;
+        record_dequeue(keep);
+    }
+
+    /**
+     * Remove items from the front of the buffer. The caller must hold the lock.
+     * @param length number of items to remove.
+     * @return true if successful, false otherwise.
+     */
+    bool discard(const std::size_t length)
+    {
+        if (length > buffer_size)
+        {
+            return false;
+        }
+
+        buffer_head = advance(buffer_head, length);
+        buffer_size -= length;
+        record_dequeue(length);
+        return true;
+    }
+
+    /**
+     * Count enqueued and overwritten items. The caller must hold the lock.
+     * @param length number of items enqueued.
+     * @param dropped number of unread items overwritten.
+     */
+    inline void record_enqueue(const std::size_t length, const std::size_t dropped)
+    {
+        if (!stats_enabled)
+        {
+            return;
+        }
+
+        stat_enqueued.fetch_add(length, std::memory_order_relaxed);
+        stat_dropped.fetch_add(dropped, std::memory_order_relaxed);
+        if (buffer_size > stat_high_water_mark.load(std::memory_order_relaxed))
+        {
+            stat_high_water_mark.store(buffer_size, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Count items removed from the buffer. The caller must hold the lock.
+     * @param length number of items removed.
+     */
+    inline void record_dequeue(const std::size_t length)
+    {
+        if (stats_enabled)
+        {
+            stat_dequeued.fetch_add(length, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Count a dequeue that found too few items. The caller must hold the lock.
+     */
+    inline void record_failed_dequeue()
+    {
+        if (stats_enabled)
+        {
+            stat_failed_dequeues.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
     /**
      * Initialize the buffer with a given length.
      * @param length length of the buffer.
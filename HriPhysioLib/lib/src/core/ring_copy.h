@@ -0,0 +1,84 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Trushar Ghanekar,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Trushar Ghanekar <trushar.ghanekar@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+
+#ifndef HRI_PHYSIO_RING_COPY_H
+#define HRI_PHYSIO_RING_COPY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * Copy a contiguous run of items, using memcpy for trivially copyable types.
+ * @tparam T
+ * @param source items to copy from.
+ * @param target items to copy to.
+ * @param length number of items to copy.
+ */
+template <class T>
+inline void ring_copy(const T *source, T *target, const std::size_t length)
+{
+    if (length == 0)
+    {
+        return;
+    }
+
+    if constexpr (std::is_trivially_copyable_v<T>)
+    {
+        std::memcpy(target, source, length * sizeof(T));
+    }
+    else
+    {
+        std::copy(source, source + length, target);
+    }
+}
+
+/**
+ * Write items into a circular array starting at a slot, splitting the
+ * transfer into at most two contiguous segments.
+ * @tparam T
+ * @param buffer circular array.
+ * @param buffer_length length of the circular array.
+ * @param position first slot to write, must be less than buffer_length.
+ * @param items items to write.
+ * @param length number of items to write, at most buffer_length.
+ */
+template <class T>
+inline void ring_write(T *buffer, const std::size_t buffer_length, const std::size_t position,
+                       const T *items, const std::size_t length)
+{
+    const std::size_t first = std::min(length, buffer_length - position);
+    ring_copy(items, buffer + position, first);
+    ring_copy(items + first, buffer, length - first);
+}
+
+/**
+ * Read items out of a circular array starting at a slot, splitting the
+ * transfer into at most two contiguous segments.
+ * @tparam T
+ * @param buffer circular array.
+ * @param buffer_length length of the circular array.
+ * @param position first slot to read, must be less than buffer_length.
+ * @param items destination for the items.
+ * @param length number of items to read, at most buffer_length.
+ */
+template <class T>
+inline void ring_read(const T *buffer, const std::size_t buffer_length, const std::size_t position,
+                      T *items, const std::size_t length)
+{
+    const std::size_t first = std::min(length, buffer_length - position);
+    ring_copy(buffer + position, items, first);
+    ring_copy(buffer, items + first, length - first);
+}
+
+#endif // HRI_PHYSIO_RING_COPY_H
@@ -0,0 +1,121 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Trushar Ghanekar,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Trushar Ghanekar <trushar.ghanekar@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+
+#ifndef HRI_PHYSIO_RING_SPAN_H
+#define HRI_PHYSIO_RING_SPAN_H
+
+#include <algorithm>
+#include <cstddef>
+#include <span>
+#include "ring_copy.h"
+
+/**
+ * @struct RingSpan
+ * @brief Read-only view over the readable region of a ring buffer.
+ *
+ * The region is split into at most two contiguous segments: first runs from
+ * the head to the end of the array, second wraps around to the start.
+ * @tparam T
+ */
+template <class T>
+struct RingSpan
+{
+    /**
+     * Segment starting at the oldest readable item.
+     */
+    std::span<const T> first;
+
+    /**
+     * Segment continuing from the start of the array, empty if the region does not wrap.
+     */
+    std::span<const T> second;
+
+    /**
+     * Get the number of items in the view.
+     * @return number of items.
+     */
+    [[nodiscard]] std::size_t size() const
+    {
+        return first.size() + second.size();
+    }
+
+    /**
+     * Check if the view is empty.
+     * @return true if empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * Get an item by its position from the oldest readable item.
+     * @param idx position of the item.
+     * @return reference to the item.
+     */
+    const T &operator[](const std::size_t idx) const
+    {
+        return (idx < first.size()) ? first[idx] : second[idx - first.size()];
+    }
+
+    /**
+     * Get a view over a run of the items in this view.
+     * @param offset position of the first item.
+     * @param count number of items, offset + count must not exceed size().
+     * @return view over the items.
+     */
+    [[nodiscard]] RingSpan subspan(const std::size_t offset, const std::size_t count) const
+    {
+        if (offset >= first.size())
+        {
+            return {second.subspan(offset - first.size(), count), {}};
+        }
+
+        const std::size_t head = std::min(count, first.size() - offset);
+        return {first.subspan(offset, head), second.first(count - head)};
+    }
+
+    /**
+     * Copy the items of the view into a contiguous array.
+     * @param items destination array of at least size() items.
+     */
+    void copy_to(T *items) const
+    {
+        ring_copy(first.data(), items, first.size());
+        ring_copy(second.data(), items + first.size(), second.size());
+    }
+};
+
+/**
+ * Build a view over count items of a circular array starting at a slot.
+ * @tparam T
+ * @param buffer circular array.
+ * @param buffer_length length of the circular array.
+ * @param position slot of the oldest item, must be less than buffer_length.
+ * @param count number of items in the view, at most buffer_length.
+ * @return view over the items.
+ */
+template <class T>
+inline RingSpan<T> make_ring_span(const T *buffer, const std::size_t buffer_length,
+                                  const std::size_t position, const std::size_t count)
+{
+    if (count == 0)
+    {
+        return {};
+    }
+
+    const std::size_t first = std::min(count, buffer_length - position);
+    return {std::span<const T>(buffer + position, first),
+            std::span<const T>(buffer, count - first)};
+}
+
+#endif // HRI_PHYSIO_RING_SPAN_H
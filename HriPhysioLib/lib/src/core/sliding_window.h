@@ -0,0 +1,162 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Trushar Ghanekar,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Trushar Ghanekar <trushar.ghanekar@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+
+#ifndef HRI_PHYSIO_SLIDING_WINDOW_H
+#define HRI_PHYSIO_SLIDING_WINDOW_H
+
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include "mirrored_ring_buffer.h"
+#include "ring_buffer.h"
+#include "ring_span.h"
+#include "spsc_ring_buffer.h"
+
+/**
+ * @class SlidingWindow
+ * @brief Walks buffered samples in overlapping windows without copying them.
+ *
+ * Windows are window() samples long and start hop() samples apart, where
+ * hop = window - overlap. This lines up with the receiver configs: window is
+ * output_frame and overlap is sample_overlap, the same overlap RingBuffer::dequeue
+ * takes. Each call to process() visits every complete window currently
+ * buffered and then consumes the samples no later window needs.
+ * @tparam T
+ */
+template <class T>
+class SlidingWindow
+{
+    /**
+     * Number of samples per window.
+     */
+    std::size_t window_length;
+
+    /**
+     * Number of samples between the starts of successive windows.
+     */
+    std::size_t hop_length;
+
+public:
+    /**
+     * Constructor to set the window geometry.
+     * @param window number of samples per window (output_frame).
+     * @param overlap number of samples shared by successive windows (sample_overlap).
+     */
+    SlidingWindow(const std::size_t window, const std::size_t overlap) : window_length(window),
+                                                                         hop_length(window - overlap)
+    {
+        if (window == 0 || overlap >= window)
+        {
+            throw std::invalid_argument("SlidingWindow needs a non-empty window longer than its overlap");
+        }
+    }
+
+    /**
+     * Get the number of samples per window.
+     * @return window length.
+     */
+    [[nodiscard]] std::size_t window() const
+    {
+        return window_length;
+    }
+
+    /**
+     * Get the number of samples between successive windows.
+     * @return hop length.
+     */
+    [[nodiscard]] std::size_t hop() const
+    {
+        return hop_length;
+    }
+
+    /**
+     * Visit every complete window of a contiguous run of samples.
+     * @param samples samples to walk, oldest first.
+     * @param func called with a std::span<const T> per window.
+     * @return number of leading samples no further window needs.
+     */
+    template <class Func>
+    std::size_t process(std::span<const T> samples, Func &&func) const
+    {
+        std::size_t start = 0;
+        for (; start + window_length <= samples.size(); start += hop_length)
+        {
+            func(samples.subspan(start, window_length));
+        }
+        return start;
+    }
+
+    /**
+     * Visit every complete window of a possibly wrapped run of samples.
+     * @param samples samples to walk, oldest first.
+     * @param func called with a RingSpan<T> per window.
+     * @return number of leading samples no further window needs.
+     */
+    template <class Func>
+    std::size_t process(const RingSpan<T> &samples, Func &&func) const
+    {
+        std::size_t start = 0;
+        for (; start + window_length <= samples.size(); start += hop_length)
+        {
+            func(samples.subspan(start, window_length));
+        }
+        return start;
+    }
+
+    /**
+     * Visit and consume every complete window in a RingBuffer. Windows that
+     * straddle the end of the array are passed as two segments.
+     * @param buffer buffer to read from; locked while the windows are visited.
+     * @param func called with a RingSpan<T> per window.
+     * @return number of windows visited.
+     */
+    template <class Func>
+    std::size_t process(RingBuffer<T> &buffer, Func &&func) const
+    {
+        auto view = buffer.peek();
+        std::size_t consumed = process(static_cast<const RingSpan<T> &>(view), func);
+        view.consume(consumed);
+        return consumed / hop_length;
+    }
+
+    /**
+     * Visit and consume every complete window in a SpscRingBuffer. Consumer thread only.
+     * @param buffer buffer to read from.
+     * @param func called with a RingSpan<T> per window.
+     * @return number of windows visited.
+     */
+    template <class Func>
+    std::size_t process(SpscRingBuffer<T> &buffer, Func &&func) const
+    {
+        std::size_t consumed = process(buffer.peek(), func);
+        buffer.consume(consumed);
+        return consumed / hop_length;
+    }
+
+    /**
+     * Visit and consume every complete window in a MirroredRingBuffer. Every
+     * window is a single contiguous span.
+     * @param buffer buffer to read from; locked while the windows are visited.
+     * @param func called with a std::span<const T> per window.
+     * @return number of windows visited.
+     */
+    template <class Func>
+    std::size_t process(MirroredRingBuffer<T> &buffer, Func &&func) const
+    {
+        auto window = buffer.peek();
+        std::size_t consumed = process(window.samples, func);
+        window.consume(consumed);
+        return consumed / hop_length;
+    }
+};
+
+#endif // HRI_PHYSIO_SLIDING_WINDOW_H
@@ -0,0 +1,398 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Trushar Ghanekar,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Trushar Ghanekar <trushar.ghanekar@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+
+#ifndef HRI_PHYSIO_SPSC_RING_BUFFER_H
+#define HRI_PHYSIO_SPSC_RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include "ring_copy.h"
+#include "ring_span.h"
+
+/**
+ * @class SpscRingBuffer
+ * @brief Lock-free ring buffer for exactly one producer and one consumer thread.
+ *
+ * Head and tail are free-running counters published with acquire/release
+ * ordering, and the capacity is rounded up to a power of two so that slot
+ * lookup is a mask instead of a modulo. Unlike RingBuffer, a full buffer
+ * rejects new items rather than overwriting the oldest ones, since only the
+ * consumer is allowed to move the head.
+ * @tparam T
+ */
+template <class T>
+class SpscRingBuffer
+{
+    /**
+     * Size used to keep the producer and consumer indices on separate cache lines.
+     */
+    static constexpr std::size_t cache_line = 64;
+
+    /**
+     * Unique pointer to the buffer array.
+     */
+    std::unique_ptr<T[]> buffer;
+
+    /**
+     * Total length of the buffer, always a power of two (or zero).
+     */
+    std::size_t buffer_length;
+
+    /**
+     * Mask used to map a counter onto a slot index.
+     */
+    std::size_t buffer_mask;
+
+    /**
+     * Number of items read so far. Written only by the consumer.
+     */
+    alignas(cache_line) std::atomic<std::size_t> buffer_head;
+
+    /**
+     * Consumer's last observed value of the tail.
+     */
+    std::size_t cached_tail;
+
+    /**
+     * Number of items written so far. Written only by the producer.
+     */
+    alignas(cache_line) std::atomic<std::size_t> buffer_tail;
+
+    /**
+     * Producer's last observed value of the head.
+     */
+    std::size_t cached_head;
+
+public:
+    /**
+     * Constructor to initialize the ring buffer with a given length.
+     * @param length minimum buffer length, rounded up to a power of two.
+     */
+    explicit SpscRingBuffer(const std::size_t length = 0) : buffer_length(0),
+                                                            buffer_mask(0),
+                                                            buffer_head(0),
+                                                            cached_tail(0),
+                                                            buffer_tail(0),
+                                                            cached_head(0)
+    {
+        buffer_init(length);
+    }
+
+    /**
+     * Deconstructor to clean up the buffer.
+     */
+    ~SpscRingBuffer()
+    {
+        buffer.reset();
+    }
+
+    /**
+     * Enqueue a single item. Producer thread only.
+     * @param item item to enqueue.
+     * @return true if successful, false if the buffer is full.
+     */
+    bool enqueue(const T &item)
+    {
+        const std::size_t tail = buffer_tail.load(std::memory_order_relaxed);
+        if (!reserve(tail, 1))
+        {
+            return false;
+        }
+
+        buffer[tail & buffer_mask] = item;
+        buffer_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Enqueue multiple items into the buffer. Producer thread only.
+     * Either all items are enqueued or none are.
+     * @param items items to enqueue.
+     * @param length number of items to enqueue.
+     * @return true if successful, false if there is not enough free space.
+     */
+    bool enqueue(const T *items, const std::size_t length)
+    {
+        const std::size_t tail = buffer_tail.load(std::memory_order_relaxed);
+        if (!reserve(tail, length))
+        {
+            return false;
+        }
+
+        ring_write(buffer.get(), buffer_length, tail & buffer_mask, items, length);
+
+        buffer_tail.store(tail + length, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Dequeue a single item from the buffer. Consumer thread only.
+     * @param item item to dequeue.
+     * @return true if successful, false otherwise.
+     */
+    bool dequeue(T &item)
+    {
+        const std::size_t head = buffer_head.load(std::memory_order_relaxed);
+        if (!available(head, 1))
+        {
+            return false;
+        }
+
+        item = buffer[head & buffer_mask];
+        buffer_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Dequeue multiple items from the buffer with optional overlap. Consumer thread only.
+     * @param items items to dequeue.
+     * @param length number of items to dequeue.
+     * @param overlap number of items to leave in the buffer for the next read.
+     * @return true if successful, false otherwise.
+     */
+    bool dequeue(T *items, const std::size_t length, const std::size_t overlap = 0)
+    {
+        if (overlap > length)
+        {
+            return false;
+        }
+
+        const std::size_t head = buffer_head.load(std::memory_order_relaxed);
+        if (!available(head, length))
+        {
+            return false;
+        }
+
+        ring_read(buffer.get(), buffer_length, head & buffer_mask, items, length);
+
+        buffer_head.store(head + (length - overlap), std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Get the item at the front of the buffer without removing it. Consumer thread only.
+     * @param item item to get.
+     * @return true if successful, false otherwise.
+     */
+    bool front(T &item)
+    {
+        const std::size_t head = buffer_head.load(std::memory_order_relaxed);
+        if (!available(head, 1))
+        {
+            return false;
+        }
+
+        item = buffer[head & buffer_mask];
+        return true;
+    }
+
+    /**
+     * Get multiple items from the front of the buffer without removing them. Consumer thread only.
+     * @param items items to get.
+     * @param length number of items to get.
+     * @return true if successful, false otherwise.
+     */
+    bool front(T *items, const std::size_t length)
+    {
+        const std::size_t head = buffer_head.load(std::memory_order_relaxed);
+        if (!available(head, length))
+        {
+            return false;
+        }
+
+        ring_read(buffer.get(), buffer_length, head & buffer_mask, items, length);
+
+        return true;
+    }
+
+    /**
+     * Get a view over all readable items without copying them. Consumer thread only.
+     * The producer never writes into the viewed region, so the view stays valid
+     * until the items are consumed.
+     * @return view over the readable items.
+     */
+    RingSpan<T> peek()
+    {
+        const std::size_t head = buffer_head.load(std::memory_order_relaxed);
+        cached_tail = buffer_tail.load(std::memory_order_acquire);
+        return make_ring_span<T>(buffer.get(), buffer_length, head & buffer_mask, cached_tail - head);
+    }
+
+    /**
+     * Remove items from the front of the buffer without reading them. Consumer thread only.
+     * @param length number of items to remove.
+     * @return true if successful, false otherwise.
+     */
+    bool consume(const std::size_t length)
+    {
+        const std::size_t head = buffer_head.load(std::memory_order_relaxed);
+        if (length != 0 && !available(head, length))
+        {
+            return false;
+        }
+
+        buffer_head.store(head + length, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Check if the buffer is empty.
+     * @return true if empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const
+    {
+        return size() == 0;
+    }
+
+    /**
+     * Check if the buffer is full.
+     * @return true if full, false otherwise.
+     */
+    [[nodiscard]] bool full() const
+    {
+        return size() >= buffer_length;
+    }
+
+    /**
+     * Get the current size of the buffer. Exact only when called from the
+     * producer or the consumer; a snapshot from any other thread.
+     * @return current size of the buffer.
+     */
+    [[nodiscard]] std::size_t size() const
+    {
+        const std::size_t head = buffer_head.load(std::memory_order_acquire);
+        const std::size_t tail = buffer_tail.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    /**
+     * Get the total length of the buffer.
+     * @return total length of the buffer.
+     */
+    [[nodiscard]] std::size_t length() const
+    {
+        return buffer_length;
+    }
+
+    /**
+     * Resize the buffer to a new length. Drops all buffered items.
+     * Not thread-safe: neither the producer nor the consumer may be active.
+     * @param length new minimum length of the buffer.
+     */
+    void resize(const std::size_t length)
+    {
+        buffer_init(length);
+    }
+
+    /**
+     * Clear the buffer by discarding every item currently readable. Consumer thread only.
+     */
+    void clear()
+    {
+        const std::size_t tail = buffer_tail.load(std::memory_order_acquire);
+        cached_tail = tail;
+        buffer_head.store(tail, std::memory_order_release);
+    }
+
+private:
+    /**
+     * Round a length up to the next power of two.
+     * @param length requested length.
+     * @return smallest power of two not less than length, or zero.
+     */
+    static std::size_t round_up(std::size_t length)
+    {
+        if (length == 0)
+        {
+            return 0;
+        }
+
+        std::size_t rounded = 1;
+        while (rounded < length)
+        {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+
+    /**
+     * Check (from the producer) that there is room for length more items.
+     * @param tail current tail counter.
+     * @param length number of items to write.
+     * @return true if there is enough free space.
+     */
+    bool reserve(const std::size_t tail, const std::size_t length)
+    {
+        if (length > buffer_length || buffer_length == 0)
+        {
+            return false;
+        }
+
+        if (tail + length - cached_head > buffer_length)
+        {
+            cached_head = buffer_head.load(std::memory_order_acquire);
+            if (tail + length - cached_head > buffer_length)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Check (from the consumer) that at least length items are readable.
+     * @param head current head counter.
+     * @param length number of items to read.
+     * @return true if enough items are buffered.
+     */
+    bool available(const std::size_t head, const std::size_t length)
+    {
+        if (length > buffer_length || buffer_length == 0)
+        {
+            return false;
+        }
+
+        if (cached_tail - head < length)
+        {
+            cached_tail = buffer_tail.load(std::memory_order_acquire);
+            if (cached_tail - head < length)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Initialize the buffer with a given length.
+     * @param length minimum length of the buffer.
+     */
+    void buffer_init(const std::size_t length)
+    {
+        buffer_length = round_up(length);
+        buffer_mask = (buffer_length != 0) ? buffer_length - 1 : 0;
+        buffer.reset(new T[buffer_length]);
+
+        buffer_head.store(0, std::memory_order_relaxed);
+        buffer_tail.store(0, std::memory_order_relaxed);
+        cached_head = 0;
+        cached_tail = 0;
+    }
+
+public:
+    // Disallow copy and assignment operators.
+    SpscRingBuffer(const SpscRingBuffer &) = delete;
+    SpscRingBuffer &operator=(const SpscRingBuffer &) = delete;
+};
+
+#endif // HRI_PHYSIO_SPSC_RING_BUFFER_H
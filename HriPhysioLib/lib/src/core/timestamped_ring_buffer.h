@@ -0,0 +1,491 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Trushar Ghanekar,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Trushar Ghanekar <trushar.ghanekar@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+
+#ifndef HRI_PHYSIO_TIMESTAMPED_RING_BUFFER_H
+#define HRI_PHYSIO_TIMESTAMPED_RING_BUFFER_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "ring_copy.h"
+
+/**
+ * @class TimestampedRingBuffer
+ * @brief Thread-safe ring buffer that keeps a timestamp alongside every item.
+ *
+ * Timestamps must be non-decreasing, which keeps the timestamp array sorted
+ * from head to tail and lets time-range queries use a binary search.
+ * Like RingBuffer, a full buffer overwrites its oldest items.
+ * @tparam T
+ */
+template <class T>
+class TimestampedRingBuffer
+{
+    /**
+     * Unique pointer to the item array.
+     */
+    std::unique_ptr<T[]> buffer;
+
+    /**
+     * Unique pointer to the timestamp array, parallel to the item array.
+     */
+    std::unique_ptr<double[]> timestamps;
+
+    /**
+     * Total length of the buffer.
+     */
+    std::size_t buffer_length;
+
+    /**
+     * Index of the head of the buffer.
+     */
+    std::size_t buffer_head;
+
+    /**
+     * Index of the tail of the buffer.
+     */
+    std::size_t buffer_tail;
+
+    /**
+     * Current size of the buffer.
+     */
+    std::size_t buffer_size;
+
+    /**
+     * Mutex for thread safety.
+     */
+    std::mutex lock;
+
+public:
+    /**
+     * Constructor to initialize the ring buffer with a given length.
+     * @param length buffer length.
+     */
+    explicit TimestampedRingBuffer(const std::size_t length = 0) : buffer_length(length),
+                                                                   buffer_head(0),
+                                                                   buffer_tail(0),
+                                                                   buffer_size(0)
+    {
+        buffer_init(length);
+    }
+
+    /**
+     * Deconstructor to clean up the buffer.
+     */
+    ~TimestampedRingBuffer()
+    {
+        buffer.reset();
+        timestamps.reset();
+    }
+
+    /**
+     * Enqueue a single item with its timestamp.
+     * @param item item to enqueue.
+     * @param timestamp time of the item, not earlier than the newest buffered timestamp.
+     * @return true if successful, false otherwise.
+     */
+    bool enqueue(const T &item, const double timestamp)
+    {
+        return enqueue(&item, &timestamp, 1);
+    }
+
+    /**
+     * Enqueue multiple items with their timestamps. If there is not enough
+     * free space, the oldest items are overwritten.
+     * @param items items to enqueue.
+     * @param stamps timestamps of the items, non-decreasing and not earlier
+     *     than the newest buffered timestamp.
+     * @param length number of items to enqueue.
+     * @return true if successful, false otherwise.
+     */
+    bool enqueue(const T *items, const double *stamps, const std::size_t length)
+    {
+        lock.lock();
+
+        if (length > buffer_length || buffer_length == 0)
+        {
+            lock.unlock();
+            return false;
+        }
+
+        if (!is_monotonic(stamps, length))
+        {
+            lock.unlock();
+            return false;
+        }
+
+        ring_write(buffer.get(), buffer_length, buffer_tail, items, length);
+        ring_write(timestamps.get(), buffer_length, buffer_tail, stamps, length);
+        buffer_tail = advance(buffer_tail, length);
+
+        if (buffer_size + length > buffer_length)
+        {
+            std::size_t dropped = buffer_size + length - buffer_length;
+            buffer_head = advance(buffer_head, dropped);
+            buffer_size = buffer_length;
+        }
+        else
+        {
+            buffer_size += length;
+        }
+
+        lock.unlock();
+        return true;
+    }
+
+    /**
+     * Dequeue a single item and its timestamp from the buffer.
+     * @param item item to dequeue.
+     * @param timestamp timestamp of the item.
+     * @return true if successful, false otherwise.
+     */
+    bool dequeue(T &item, double &timestamp)
+    {
+        lock.lock();
+
+        if (buffer_size == 0)
+        {
+            lock.unlock();
+            return false;
+        }
+
+        item = buffer[buffer_head];
+        timestamp = timestamps[buffer_head];
+        buffer_head = advance(buffer_head, 1);
+        --buffer_size;
+
+        lock.unlock();
+        return true;
+    }
+
+    /**
+     * Copy all items with a timestamp in [t0, t1] without removing them.
+     * @param t0 start of the time range.
+     * @param t1 end of the time range.
+     * @param items destination for the items, resized to the number found.
+     * @param stamps optional destination for the timestamps.
+     * @return number of items found.
+     */
+    std::size_t range(const double t0, const double t1, std::vector<T> &items, std::vector<double> *stamps = nullptr)
+    {
+        lock.lock();
+
+        std::size_t first = lower_bound(t0);
+        std::size_t last = upper_bound(t1);
+        std::size_t count = (last > first) ? last - first : 0;
+        copy_range(first, count, items, stamps);
+
+        lock.unlock();
+        return count;
+    }
+
+    /**
+     * Copy all items from the last few seconds, measured back from the
+     * newest timestamp, without removing them.
+     * @param seconds length of the time window.
+     * @param items destination for the items, resized to the number found.
+     * @param stamps optional destination for the timestamps.
+     * @return number of items found.
+     */
+    std::size_t last(const double seconds, std::vector<T> &items, std::vector<double> *stamps = nullptr)
+    {
+        lock.lock();
+
+        std::size_t count = 0;
+        if (buffer_size != 0)
+        {
+            std::size_t first = lower_bound(newest_locked() - seconds);
+            count = buffer_size - first;
+            copy_range(first, count, items, stamps);
+        }
+        else
+        {
+            copy_range(0, 0, items, stamps);
+        }
+
+        lock.unlock();
+        return count;
+    }
+
+    /**
+     * Remove all items with a timestamp earlier than a given time.
+     * @param timestamp items older than this are dropped.
+     * @return number of items removed.
+     */
+    std::size_t discard_before(const double timestamp)
+    {
+        lock.lock();
+
+        std::size_t count = lower_bound(timestamp);
+        buffer_head = advance(buffer_head, count);
+        buffer_size -= count;
+
+        lock.unlock();
+        return count;
+    }
+
+    /**
+     * Get the timestamp of the oldest item.
+     * @param timestamp oldest timestamp.
+     * @return true if successful, false if the buffer is empty.
+     */
+    bool oldest(double &timestamp)
+    {
+        lock.lock();
+
+        bool ret = buffer_size != 0;
+        if (ret)
+        {
+            timestamp = timestamps[buffer_head];
+        }
+
+        lock.unlock();
+        return ret;
+    }
+
+    /**
+     * Get the timestamp of the newest item.
+     * @param timestamp newest timestamp.
+     * @return true if successful, false if the buffer is empty.
+     */
+    bool newest(double &timestamp)
+    {
+        lock.lock();
+
+        bool ret = buffer_size != 0;
+        if (ret)
+        {
+            timestamp = newest_locked();
+        }
+
+        lock.unlock();
+        return ret;
+    }
+
+    /**
+     * Check if the buffer is empty.
+     * @return true if empty, false otherwise.
+     */
+    bool empty()
+    {
+        return buffer_size == 0;
+    }
+
+    /**
+     * Check if the buffer is full.
+     * @return true if full, false otherwise.
+     */
+    bool full()
+    {
+        return buffer_size >= buffer_length;
+    }
+
+    /**
+     * Get the current size of the buffer.
+     * @return current size of the buffer.
+     */
+    std::size_t size()
+    {
+        return buffer_size;
+    }
+
+    /**
+     * Get the total length of the buffer.
+     * @return total length of the buffer.
+     */
+    [[nodiscard]] std::size_t length() const
+    {
+        return buffer_length;
+    }
+
+    /**
+     * Resize the buffer to a new length. Drops all buffered items.
+     * @param length new length of the buffer.
+     */
+    void resize(const std::size_t length)
+    {
+        lock.lock();
+
+        buffer_length = length;
+        buffer_init(buffer_length);
+
+        lock.unlock();
+    }
+
+    /**
+     * Clear the buffer.
+     */
+    void clear()
+    {
+        lock.lock();
+
+        buffer_size = 0;
+        buffer_head = 0;
+        buffer_tail = 0;
+
+        lock.unlock();
+    }
+
+private:
+    /**
+     * Move an index forward around the buffer without a modulo.
+     * @param index index to move.
+     * @param count number of slots to move, at most buffer_length.
+     * @return the wrapped index.
+     */
+    [[nodiscard]] inline std::size_t advance(std::size_t index, const std::size_t count) const
+    {
+        index += count;
+        return (index >= buffer_length) ? index - buffer_length : index;
+    }
+
+    /**
+     * Get the timestamp at a position counted from the head. The caller must hold the lock.
+     * @param idx position from the head.
+     * @return timestamp at that position.
+     */
+    [[nodiscard]] inline double stamp_at(const std::size_t idx) const
+    {
+        return timestamps[advance(buffer_head, idx)];
+    }
+
+    /**
+     * Get the newest timestamp. The caller must hold the lock and the buffer must not be empty.
+     * @return newest timestamp.
+     */
+    [[nodiscard]] double newest_locked() const
+    {
+        return stamp_at(buffer_size - 1);
+    }
+
+    /**
+     * Check that a run of timestamps can be appended without breaking the ordering.
+     * @param stamps timestamps to append.
+     * @param length number of timestamps.
+     * @return true if the run is non-decreasing and starts at or after the newest timestamp.
+     */
+    bool is_monotonic(const double *stamps, const std::size_t length) const
+    {
+        if (length == 0)
+        {
+            return true;
+        }
+
+        double previous = (buffer_size != 0) ? newest_locked() : stamps[0];
+        for (std::size_t idx = 0; idx < length; ++idx)
+        {
+            if (stamps[idx] < previous)
+            {
+                return false;
+            }
+            previous = stamps[idx];
+        }
+        return true;
+    }
+
+    /**
+     * Find the first position from the head whose timestamp is not earlier than a time.
+     * @param timestamp time to search for.
+     * @return position from the head, buffer_size if none.
+     */
+    [[nodiscard]] std::size_t lower_bound(const double timestamp) const
+    {
+        std::size_t low = 0;
+        std::size_t high = buffer_size;
+        while (low < high)
+        {
+            std::size_t mid = low + ((high - low) >> 1);
+            if (stamp_at(mid) < timestamp)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+    /**
+     * Find the first position from the head whose timestamp is later than a time.
+     * @param timestamp time to search for.
+     * @return position from the head, buffer_size if none.
+     */
+    [[nodiscard]] std::size_t upper_bound(const double timestamp) const
+    {
+        std::size_t low = 0;
+        std::size_t high = buffer_size;
+        while (low < high)
+        {
+            std::size_t mid = low + ((high - low) >> 1);
+            if (stamp_at(mid) <= timestamp)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+    /**
+     * Copy a run of items and timestamps out of the buffer. The caller must hold the lock.
+     * @param first position of the first item from the head.
+     * @param count number of items to copy.
+     * @param items destination for the items.
+     * @param stamps optional destination for the timestamps.
+     */
+    void copy_range(const std::size_t first, const std::size_t count,
+                    std::vector<T> &items, std::vector<double> *stamps) const
+    {
+        const std::size_t position = advance(buffer_head, first);
+
+        items.resize(count);
+        if (count != 0)
+        {
+            ring_read(buffer.get(), buffer_length, position, items.data(), count);
+        }
+
+        if (stamps != nullptr)
+        {
+            stamps->resize(count);
+            if (count != 0)
+            {
+                ring_read(timestamps.get(), buffer_length, position, stamps->data(), count);
+            }
+        }
+    }
+
+    /**
+     * Initialize the buffer with a given length.
+     * @param length length of the buffer.
+     */
+    void buffer_init(const std::size_t length)
+    {
+        buffer.reset(new T[length]);
+        timestamps.reset(new double[length]);
+
+        buffer_size = 0;
+        buffer_head = 0;
+        buffer_tail = 0;
+    }
+
+public:
+    // Disallow copy and assignment operators.
+    TimestampedRingBuffer(const TimestampedRingBuffer &) = delete;
+    TimestampedRingBuffer &operator=(const TimestampedRingBuffer &) = delete;
+};
+
+#endif // HRI_PHYSIO_TIMESTAMPED_RING_BUFFER_H
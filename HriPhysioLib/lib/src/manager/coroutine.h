@@ -0,0 +1,419 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Vedika Chauhan,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Vedika Chauhan <vedika.chauhan@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+
+#ifndef HRI_PHYSIO_MANAGER_COROUTINE_H
+#define HRI_PHYSIO_MANAGER_COROUTINE_H
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+#include "timer_wheel.h"
+
+/**
+ * @class PendingResume
+ * @brief A suspended coroutine waiting for one of several wake-up sources.
+ *
+ * Every source (timer, data event) holds a shared pointer. The first one to
+ * claim() it wins and resumes the coroutine; the others find it claimed and
+ * do nothing. If every source is dropped before the coroutine was resumed,
+ * e.g. because the manager closed, the coroutine frame is destroyed.
+ */
+class PendingResume
+{
+    /**
+     * The suspended coroutine.
+     */
+    std::coroutine_handle<> handle;
+
+    /**
+     * Flag set by the wake-up source that won.
+     */
+    std::atomic<bool> claimed;
+
+    /**
+     * Flag set once the coroutine has been resumed.
+     */
+    std::atomic<bool> resumed;
+
+public:
+    /**
+     * Constructor to wrap a suspended coroutine.
+     * @param handle Coroutine to resume later.
+     */
+    explicit PendingResume(std::coroutine_handle<> handle) : handle(handle), claimed(false), resumed(false) {}
+
+    /**
+     * Destructor destroys the coroutine if nobody resumed it.
+     */
+    ~PendingResume()
+    {
+        if (!resumed)
+        {
+            handle.destroy();
+        }
+    }
+
+    /**
+     * Try to become the source that resumes the coroutine.
+     * @return True for the first caller only.
+     */
+    bool claim()
+    {
+        return !claimed.exchange(true);
+    }
+
+    /**
+     * Check whether a wake-up source already won.
+     * @return True if claimed, false otherwise.
+     */
+    [[nodiscard]] bool is_claimed() const
+    {
+        return claimed;
+    }
+
+    /**
+     * Resume the coroutine. Only the source that claimed it may call this.
+     */
+    void resume()
+    {
+        resumed = true;
+        handle.resume();
+    }
+
+    // Disallow copy and assignment operators.
+    PendingResume(const PendingResume &) = delete;
+    PendingResume &operator=(const PendingResume &) = delete;
+};
+
+/**
+ * @class Task
+ * @brief Return type of a coroutine run by ThreadManager::spawn().
+ *
+ * The coroutine does not start until it is spawned, and it frees itself
+ * when it finishes. Its result, or the exception it threw, is delivered
+ * through the future returned by spawn().
+ */
+class Task
+{
+public:
+    /**
+     * @struct promise_type
+     * @brief Coroutine promise holding the completion signal.
+     */
+    struct promise_type
+    {
+        /**
+         * Completion signal handed out by spawn().
+         */
+        std::promise<void> done;
+
+        Task get_return_object()
+        {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        std::suspend_never final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void()
+        {
+            done.set_value();
+        }
+
+        void unhandled_exception()
+        {
+            done.set_exception(std::current_exception());
+        }
+    };
+
+private:
+    /**
+     * The coroutine, until it is released to an executor.
+     */
+    std::coroutine_handle<promise_type> handle;
+
+public:
+    /**
+     * Constructor to take ownership of a coroutine.
+     * @param handle Coroutine that has not started yet.
+     */
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    /**
+     * Move constructor.
+     * @param other Task to take the coroutine from.
+     */
+    Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+    /**
+     * Destructor frees a coroutine that was never spawned.
+     */
+    ~Task()
+    {
+        if (handle)
+        {
+            handle.destroy();
+        }
+    }
+
+    /**
+     * Hand the coroutine over to an executor.
+     * @return The coroutine; this task no longer owns it.
+     */
+    std::coroutine_handle<promise_type> release()
+    {
+        return std::exchange(handle, nullptr);
+    }
+
+    // Disallow copy and assignment operators.
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+};
+
+/**
+ * @class Delay
+ * @brief Awaitable that resumes the coroutine on the timer wheel after a delay.
+ */
+class Delay
+{
+    /**
+     * Wheel that resumes the coroutine.
+     */
+    TimerWheel *wheel;
+
+    /**
+     * Delay in seconds.
+     */
+    double seconds;
+
+public:
+    /**
+     * Constructor to set the wheel and the delay.
+     * @param wheel Wheel that resumes the coroutine.
+     * @param seconds Delay in seconds.
+     */
+    Delay(TimerWheel &wheel, double seconds) : wheel(&wheel), seconds(seconds) {}
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<> handle) const
+    {
+        auto pending = std::make_shared<PendingResume>(handle);
+        pending->claim();
+        wheel->schedule_once(seconds, [pending]
+                             { pending->resume(); });
+    }
+
+    void await_resume() const noexcept {}
+};
+
+/**
+ * @class DataEvent
+ * @brief Lets coroutines wait for the next value from a producer thread.
+ *
+ * A producer (e.g. an LSL receive loop) calls publish() for every new value;
+ * every coroutine waiting in next() or next_for() at that moment is resumed
+ * on the timer wheel with that value. Values published while nobody waits
+ * are not queued; use a ring buffer when every sample matters.
+ * @tparam T
+ */
+template <class T>
+class DataEvent
+{
+    /**
+     * @struct Waiter
+     * @brief One suspended coroutine and where its value goes.
+     */
+    struct Waiter
+    {
+        /**
+         * The suspended coroutine.
+         */
+        std::shared_ptr<PendingResume> pending;
+
+        /**
+         * Result slot inside the coroutine's awaiter.
+         */
+        std::optional<T> *result;
+    };
+
+    /**
+     * Wheel that resumes the coroutines.
+     */
+    TimerWheel *wheel;
+
+    /**
+     * Coroutines waiting for the next value.
+     */
+    std::vector<Waiter> waiters;
+
+    /**
+     * Mutex guarding the waiters.
+     */
+    std::mutex lock;
+
+public:
+    /**
+     * @class Awaiter
+     * @brief Awaitable returned by next() and next_for().
+     */
+    class Awaiter
+    {
+        /**
+         * Event to wait on.
+         */
+        DataEvent *event;
+
+        /**
+         * Timeout in seconds, 0 to wait forever.
+         */
+        double timeout;
+
+        /**
+         * Value received, empty on timeout.
+         */
+        std::optional<T> result;
+
+    public:
+        /**
+         * Constructor to set the event and the timeout.
+         * @param event Event to wait on.
+         * @param timeout Timeout in seconds, 0 to wait forever.
+         */
+        Awaiter(DataEvent *event, double timeout) : event(event), timeout(timeout) {}
+
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            //-- Either wake-up may resume the coroutine at once, so nothing here touches *this afterwards.
+            DataEvent *target = event;
+            std::optional<T> *slot = &result;
+            auto pending = std::make_shared<PendingResume>(handle);
+
+            if (timeout > 0.0)
+            {
+                target->wheel->schedule_once(timeout, [pending]
+                                             {
+                                                 if (pending->claim())
+                                                 {
+                                                     pending->resume();
+                                                 } });
+            }
+
+            //-- Drop waiters whose timeout already fired, so a quiet event does not grow without bound.
+            std::lock_guard<std::mutex> guard(target->lock);
+            std::erase_if(target->waiters, [](const Waiter &waiter)
+                          { return waiter.pending->is_claimed(); });
+            target->waiters.push_back({pending, slot});
+        }
+
+        std::optional<T> await_resume()
+        {
+            return std::move(result);
+        }
+    };
+
+    /**
+     * Constructor to set the wheel that resumes waiting coroutines.
+     * @param wheel Wheel that resumes the coroutines.
+     */
+    explicit DataEvent(TimerWheel &wheel) : wheel(&wheel) {}
+
+    /**
+     * Wake every waiting coroutine with a new value. Safe to call from any thread.
+     * @param value Value to hand to the coroutines.
+     */
+    void publish(const T &value)
+    {
+        std::vector<Waiter> woken;
+        lock.lock();
+        woken.swap(waiters);
+        lock.unlock();
+
+        for (auto &waiter : woken)
+        {
+            if (waiter.pending->claim())
+            {
+                *waiter.result = value;
+                wheel->schedule_once(0.0, [pending = waiter.pending]
+                                     { pending->resume(); });
+            }
+        }
+    }
+
+    /**
+     * Wait for the next published value.
+     * @return Awaitable yielding a std::optional<T> that is always set.
+     */
+    Awaiter next()
+    {
+        return Awaiter(this, 0.0);
+    }
+
+    /**
+     * Wait for the next published value, giving up after a timeout.
+     * @param timeout Timeout in seconds.
+     * @return Awaitable yielding the value, or std::nullopt on timeout.
+     */
+    Awaiter next_for(double timeout)
+    {
+        return Awaiter(this, timeout);
+    }
+
+    // Disallow copy and assignment operators.
+    DataEvent(const DataEvent &) = delete;
+    DataEvent &operator=(const DataEvent &) = delete;
+};
+
+/**
+ * Start a coroutine on a timer wheel. Every step of the coroutine between
+ * two co_awaits runs on the wheel thread, so coroutines spawned on the same
+ * wheel never run concurrently and never block a thread while they wait.
+ * @param wheel Wheel that runs the coroutine.
+ * @param task Coroutine to start.
+ * @return Future that completes when the coroutine returns, holds its
+ *     exception if it threw, or reports a broken promise if it was still
+ *     suspended when the wheel shut down.
+ */
+inline std::future<void> spawn(TimerWheel &wheel, Task task)
+{
+    auto handle = task.release();
+    std::future<void> done = handle.promise().done.get_future();
+
+    auto pending = std::make_shared<PendingResume>(handle);
+    pending->claim();
+    wheel.schedule_once(0.0, [pending]
+                        { pending->resume(); });
+    return done;
+}
+
+#endif /* HRI_PHYSIO_MANAGER_COROUTINE_H */
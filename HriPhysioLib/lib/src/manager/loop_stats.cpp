@@ -0,0 +1,85 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Vedika Chauhan,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Vedika Chauhan <vedika.chauhan@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+
+#include "loop_stats.h"
+#include <algorithm>
+#include <cmath>
+
+double HistogramSnapshot::mean() const
+{
+    if (count == 0)
+    {
+        return 0.0;
+    }
+    return static_cast<double>(sum) / static_cast<double>(count) * 1e-9;
+}
+
+double HistogramSnapshot::percentile(double quantile) const
+{
+    if (count == 0)
+    {
+        return 0.0;
+    }
+
+    //-- Rank of the requested sample, 1-based.
+    quantile = std::clamp(quantile, 0.0, 1.0);
+    const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(quantile * static_cast<double>(count))));
+
+    std::uint64_t seen = 0;
+    for (std::size_t idx = 0; idx < counts.size(); ++idx)
+    {
+        seen += counts[idx];
+        if (seen >= rank)
+        {
+            //-- Report the upper edge of the bucket, but never more than the largest sample.
+            const std::uint64_t upper = (idx + 1 < counts.size()) ? LatencyHistogram::bucket_lower(idx + 1) - 1 : max;
+            return static_cast<double>(std::min(upper, max)) * 1e-9;
+        }
+    }
+    return static_cast<double>(max) * 1e-9;
+}
+
+LatencyHistogram::LatencyHistogram() : sum(0),
+                                       max(0)
+{
+    for (auto &bucket : buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const
+{
+    HistogramSnapshot snap;
+    snap.counts.resize(num_buckets);
+
+    //-- Counters are read one by one, so the total is taken from the buckets themselves.
+    for (std::size_t idx = 0; idx < num_buckets; ++idx)
+    {
+        snap.counts[idx] = buckets[idx].load(std::memory_order_relaxed);
+        snap.count += snap.counts[idx];
+    }
+    snap.sum = sum.load(std::memory_order_relaxed);
+    snap.max = max.load(std::memory_order_relaxed);
+
+    return snap;
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto &bucket : buckets)
+    {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    sum.store(0, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,236 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Vedika Chauhan,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Vedika Chauhan <vedika.chauhan@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+
+#ifndef HRI_PHYSIO_MANAGER_LOOP_STATS_H
+#define HRI_PHYSIO_MANAGER_LOOP_STATS_H
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @struct HistogramSnapshot
+ * @brief Copy of a LatencyHistogram taken at one point in time.
+ */
+struct HistogramSnapshot
+{
+    /**
+     * Number of samples per bucket.
+     */
+    std::vector<std::uint64_t> counts;
+
+    /**
+     * Total number of samples.
+     */
+    std::uint64_t count = 0;
+
+    /**
+     * Sum of all samples in nanoseconds.
+     */
+    std::uint64_t sum = 0;
+
+    /**
+     * Largest sample in nanoseconds.
+     */
+    std::uint64_t max = 0;
+
+    /**
+     * Get the mean of the samples.
+     * @return mean in seconds, 0 if empty.
+     */
+    [[nodiscard]] double mean() const;
+
+    /**
+     * Get an upper bound for a percentile of the samples.
+     * @param quantile fraction of samples at or below the result, in [0, 1].
+     * @return upper edge of the bucket holding that quantile in seconds, 0 if empty.
+     */
+    [[nodiscard]] double percentile(double quantile) const;
+};
+
+/**
+ * @class LatencyHistogram
+ * @brief Lock-free log-linear histogram of durations in nanoseconds.
+ *
+ * Every power of two is split into 8 linear buckets, so any sample is known
+ * to within 12.5% while the whole range up to ~18 minutes fits in a few
+ * hundred counters. Recording is a handful of relaxed atomic adds, so the
+ * owning thread never blocks and readers may snapshot at any time.
+ */
+class LatencyHistogram
+{
+public:
+    /**
+     * Number of linear buckets per power of two, as a power of two.
+     */
+    static constexpr unsigned sub_bits = 3;
+
+    /**
+     * Largest power of two tracked; longer samples land in the last bucket.
+     */
+    static constexpr unsigned max_exponent = 40;
+
+    /**
+     * Total number of buckets.
+     */
+    static constexpr std::size_t num_buckets = (max_exponent - sub_bits + 2) << sub_bits;
+
+private:
+    /**
+     * Number of samples per bucket.
+     */
+    std::array<std::atomic<std::uint64_t>, num_buckets> buckets;
+
+    /**
+     * Sum of all samples.
+     */
+    std::atomic<std::uint64_t> sum;
+
+    /**
+     * Largest sample.
+     */
+    std::atomic<std::uint64_t> max;
+
+public:
+    /**
+     * Constructor to start with an empty histogram.
+     */
+    LatencyHistogram();
+
+    /**
+     * Record one sample.
+     * @param nanoseconds duration to record.
+     */
+    void record(std::uint64_t nanoseconds)
+    {
+        buckets[bucket_index(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+        //-- Only the owning loop records, so a plain compare is enough.
+        if (nanoseconds > max.load(std::memory_order_relaxed))
+        {
+            max.store(nanoseconds, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Copy the current counts.
+     * @return snapshot of the histogram.
+     */
+    [[nodiscard]] HistogramSnapshot snapshot() const;
+
+    /**
+     * Drop all recorded samples.
+     */
+    void reset();
+
+    /**
+     * Map a duration to its bucket.
+     * @param nanoseconds duration.
+     * @return index of the bucket.
+     */
+    static constexpr std::size_t bucket_index(std::uint64_t nanoseconds)
+    {
+        constexpr std::uint64_t linear = std::uint64_t{1} << sub_bits;
+        if (nanoseconds < linear)
+        {
+            return static_cast<std::size_t>(nanoseconds);
+        }
+
+        const unsigned exponent = std::bit_width(nanoseconds) - 1;
+        if (exponent > max_exponent)
+        {
+            return num_buckets - 1;
+        }
+
+        const std::uint64_t sub = (nanoseconds >> (exponent - sub_bits)) & (linear - 1);
+        return static_cast<std::size_t>(((exponent - sub_bits + 1) << sub_bits) + sub);
+    }
+
+    /**
+     * Get the smallest duration that maps to a bucket.
+     * @param index index of the bucket.
+     * @return lower edge of the bucket in nanoseconds.
+     */
+    static constexpr std::uint64_t bucket_lower(std::size_t index)
+    {
+        constexpr std::uint64_t linear = std::uint64_t{1} << sub_bits;
+        if (index < linear)
+        {
+            return index;
+        }
+
+        const unsigned exponent = static_cast<unsigned>(index >> sub_bits) + sub_bits - 1;
+        const std::uint64_t sub = index & (linear - 1);
+        return (linear + sub) << (exponent - sub_bits);
+    }
+};
+
+/**
+ * @struct LoopStats
+ * @brief Timing counters recorded by one loop thread.
+ */
+struct LoopStats
+{
+    /**
+     * Time spent in the loop function per iteration.
+     */
+    LatencyHistogram execution;
+
+    /**
+     * How late each iteration started relative to its deadline.
+     */
+    LatencyHistogram jitter;
+
+    /**
+     * Number of iterations that ran past their next deadline.
+     */
+    std::atomic<std::uint64_t> overruns{0};
+};
+
+/**
+ * @struct LoopStatsSnapshot
+ * @brief Copy of the timing counters of one loop thread.
+ */
+struct LoopStatsSnapshot
+{
+    /**
+     * ID of the loop thread.
+     */
+    std::thread::id thread_id;
+
+    /**
+     * Name the loop thread was given in its ThreadOptions, if any.
+     */
+    std::string name;
+
+    /**
+     * Time spent in the loop function per iteration.
+     */
+    HistogramSnapshot execution;
+
+    /**
+     * How late each iteration started relative to its deadline.
+     */
+    HistogramSnapshot jitter;
+
+    /**
+     * Number of iterations that ran past their next deadline.
+     */
+    std::uint64_t overruns = 0;
+};
+
+#endif /* HRI_PHYSIO_MANAGER_LOOP_STATS_H */
@@ -44,6 +44,10 @@ void RobotManager::configure(int argc, char **argv)
     log_data = config["log_data"].as<bool>(false);
     log_name = config["log_name"].as<std::string>("");
 
+    //-- Optional per-loop name, CPU affinity and real-time priority.
+    self_loop_options = ThreadOptions::from_yaml(config["threads"]["self_loop"], "self_loop");
+    input_loop_options = ThreadOptions::from_yaml(config["threads"]["input_loop"], "input_loop");
+
     if (log_data && log_name.empty())
     {
         this->close();
@@ -83,9 +87,9 @@ void RobotManager::interactive()
 bool RobotManager::thread_init()
 {
     add_loop_thread([this]
-                    { self_loop(); });
+                    { self_loop(); }, 0.0, true, OverrunPolicy::SKIP, self_loop_options);
     add_loop_thread([this]
-                    { input_loop(); });
+                    { input_loop(); }, 0.0, true, OverrunPolicy::SKIP, input_loop_options);
     return true;
 }
 
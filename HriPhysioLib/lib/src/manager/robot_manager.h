@@ -58,6 +58,16 @@ class RobotManager final : public ThreadManager
      */
     RobotInterface *robot;
 
+    /**
+     * Thread options for the robot loop, read from the "threads" section of the config.
+     */
+    ThreadOptions self_loop_options;
+
+    /**
+     * Thread options for the command input loop, read from the "threads" section of the config.
+     */
+    ThreadOptions input_loop_options;
+
     /**
      * Start time of the robot manager.
      */
@@ -0,0 +1,166 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Vedika Chauhan,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Vedika Chauhan <vedika.chauhan@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+
+#include "task_pool.h"
+
+namespace
+{
+    //-- Pool and deque index of the current thread, if it is a worker.
+    thread_local const TaskPool *current_pool = nullptr;
+    thread_local std::size_t current_index = 0;
+}
+
+TaskPool::TaskPool(std::size_t num_workers) : pending(0),
+                                              next_worker(0),
+                                              running(true)
+{
+    //-- Default to one worker per hardware thread.
+    if (num_workers == 0)
+    {
+        num_workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    //-- Create all deques before any worker can try to steal from them.
+    for (std::size_t idx = 0; idx < num_workers; ++idx)
+    {
+        workers.push_back(std::make_unique<Worker>());
+    }
+
+    for (std::size_t idx = 0; idx < num_workers; ++idx)
+    {
+        threads.emplace_back(&TaskPool::worker_loop, this, idx);
+    }
+}
+
+TaskPool::~TaskPool()
+{
+    //-- Tell the workers to finish up once the deques are empty.
+    {
+        std::lock_guard<std::mutex> guard(idle_lock);
+        running = false;
+    }
+    idle.notify_all();
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+}
+
+bool TaskPool::run_pending_task()
+{
+    const std::size_t index = (current_pool == this) ? current_index : next_worker.load(std::memory_order_relaxed);
+
+    std::function<void()> task;
+    if (!pop(index % workers.size(), task))
+    {
+        return false;
+    }
+
+    task();
+    return true;
+}
+
+std::size_t TaskPool::size() const
+{
+    return workers.size();
+}
+
+void TaskPool::push(std::function<void()> task)
+{
+    //-- Workers keep their own tasks local; everyone else spreads them out.
+    const std::size_t index = (current_pool == this)
+                                  ? current_index
+                                  : next_worker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+
+    //-- Count the task before it becomes visible, so pending never underflows.
+    pending.fetch_add(1);
+
+    Worker &worker = *workers[index];
+    worker.lock.lock();
+    worker.tasks.push_back(std::move(task));
+    worker.lock.unlock();
+
+    //-- Pass through the idle lock before notifying, so a wake-up cannot be lost.
+    {
+        std::lock_guard<std::mutex> guard(idle_lock);
+    }
+    idle.notify_one();
+}
+
+bool TaskPool::pop(std::size_t index, std::function<void()> &task)
+{
+    //-- Newest task from the own deque.
+    Worker &own = *workers[index];
+    own.lock.lock();
+    if (!own.tasks.empty())
+    {
+        task = std::move(own.tasks.back());
+        own.tasks.pop_back();
+        own.lock.unlock();
+        pending.fetch_sub(1);
+        return true;
+    }
+    own.lock.unlock();
+
+    //-- Oldest task from any other deque.
+    for (std::size_t offset = 1; offset < workers.size(); ++offset)
+    {
+        Worker &victim = *workers[(index + offset) % workers.size()];
+        if (!victim.lock.try_lock())
+        {
+            continue;
+        }
+
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            victim.lock.unlock();
+            pending.fetch_sub(1);
+            return true;
+        }
+        victim.lock.unlock();
+    }
+
+    return false;
+}
+
+void TaskPool::worker_loop(std::size_t index)
+{
+    current_pool = this;
+    current_index = index;
+
+    std::function<void()> task;
+    while (true)
+    {
+        if (pop(index, task))
+        {
+            task();
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(idle_lock);
+        idle.wait(guard, [this] { return !running || pending.load() > 0; });
+
+        //-- Leave only once every queued task has been run.
+        if (!running && pending.load() == 0)
+        {
+            break;
+        }
+
+        //-- Work is pending but its deque was locked, so give the holder a turn before stealing again.
+        guard.unlock();
+        std::this_thread::yield();
+    }
+}
@@ -0,0 +1,220 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Vedika Chauhan,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Vedika Chauhan <vedika.chauhan@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+
+#ifndef HRI_PHYSIO_MANAGER_TASK_POOL_H
+#define HRI_PHYSIO_MANAGER_TASK_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class TaskPool
+ * @brief Work-stealing executor for short jobs.
+ *
+ * Every worker owns a deque. Tasks submitted from a worker go to the back of
+ * its own deque and are taken from there (newest first, while the data is
+ * still in cache); tasks submitted from other threads are dealt round-robin.
+ * An idle worker steals the oldest task from the front of another worker's
+ * deque before going to sleep.
+ */
+class TaskPool
+{
+    /**
+     * @struct Worker
+     * @brief Task deque of one worker thread.
+     */
+    struct Worker
+    {
+        /**
+         * Queued tasks; the owner works at the back, thieves at the front.
+         */
+        std::deque<std::function<void()>> tasks;
+
+        /**
+         * Mutex guarding the deque. Only contended while stealing.
+         */
+        std::mutex lock;
+    };
+
+    /**
+     * One deque per worker thread.
+     */
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    /**
+     * The worker threads.
+     */
+    std::vector<std::thread> threads;
+
+    /**
+     * Number of queued tasks not yet taken by any thread.
+     */
+    std::atomic<std::size_t> pending;
+
+    /**
+     * Round-robin counter for tasks submitted from outside the pool.
+     */
+    std::atomic<std::size_t> next_worker;
+
+    /**
+     * Atomic flag to indicate if the workers should keep running.
+     */
+    std::atomic<bool> running;
+
+    /**
+     * Mutex and condition used to park idle workers.
+     */
+    std::mutex idle_lock;
+    std::condition_variable idle;
+
+public:
+    /**
+     * Constructor to spawn the workers.
+     * @param num_workers number of worker threads, 0 for one per hardware thread.
+     */
+    explicit TaskPool(std::size_t num_workers = 0);
+
+    /**
+     * Destructor runs the remaining tasks and joins the workers.
+     */
+    ~TaskPool();
+
+    /**
+     * Queue a task.
+     * @param func callable taking no arguments.
+     * @return future holding the result, or the exception thrown by func.
+     */
+    template <class Func>
+    auto submit(Func &&func) -> std::future<std::invoke_result_t<std::decay_t<Func>>>
+    {
+        using Result = std::invoke_result_t<std::decay_t<Func>>;
+
+        //-- std::function needs a copyable target, so the packaged task is shared.
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+        std::future<Result> result = task->get_future();
+        push([task] { (*task)(); });
+        return result;
+    }
+
+    /**
+     * Call func(idx) for every idx in [begin, end), split into chunks across
+     * the workers. The calling thread runs queued tasks while it waits, so
+     * this may also be called from inside a task.
+     * @param begin first index.
+     * @param end one past the last index.
+     * @param func callable taking a std::size_t.
+     * @param grain indices per task, 0 to pick one from the pool size.
+     */
+    template <class Func>
+    void parallel_for(std::size_t begin, std::size_t end, Func &&func, std::size_t grain = 0)
+    {
+        if (end <= begin)
+        {
+            return;
+        }
+
+        const std::size_t count = end - begin;
+        if (grain == 0)
+        {
+            grain = std::max<std::size_t>(1, count / (4 * size()));
+        }
+
+        std::vector<std::future<void>> chunks;
+        chunks.reserve((count + grain - 1) / grain);
+        for (std::size_t first = begin; first < end; first += grain)
+        {
+            const std::size_t last = std::min(end, first + grain);
+            chunks.push_back(submit([&func, first, last] {
+                for (std::size_t idx = first; idx < last; ++idx)
+                {
+                    func(idx);
+                }
+            }));
+        }
+
+        for (auto &chunk : chunks)
+        {
+            wait_helping(chunk);
+        }
+        for (auto &chunk : chunks)
+        {
+            chunk.get();
+        }
+    }
+
+    /**
+     * Take one queued task and run it on the calling thread.
+     * @return true if a task was run, false if none was queued.
+     */
+    bool run_pending_task();
+
+    /**
+     * Get the number of worker threads.
+     * @return number of workers.
+     */
+    [[nodiscard]] std::size_t size() const;
+
+private:
+    /**
+     * Wait for a future while running queued tasks, so a task waiting on
+     * other tasks cannot starve the pool.
+     * @param result future to wait for.
+     */
+    template <class Result>
+    void wait_helping(std::future<Result> &result)
+    {
+        while (result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            if (!run_pending_task())
+            {
+                //-- Everything left is already running somewhere.
+                result.wait();
+            }
+        }
+    }
+
+    /**
+     * Queue a task on the caller's own deque, or round-robin from outside the pool.
+     * @param task task to queue.
+     */
+    void push(std::function<void()> task);
+
+    /**
+     * Take a task, from the back of the own deque first, then from the front of the others.
+     * @param index deque to start from.
+     * @param task destination for the task.
+     * @return true if a task was taken.
+     */
+    bool pop(std::size_t index, std::function<void()> &task);
+
+    /**
+     * Main loop of a worker thread.
+     * @param index index of the worker.
+     */
+    void worker_loop(std::size_t index);
+
+public:
+    // Disallow copy and assignment operators.
+    TaskPool(const TaskPool &) = delete;
+    TaskPool &operator=(const TaskPool &) = delete;
+};
+
+#endif /* HRI_PHYSIO_MANAGER_TASK_POOL_H */
@@ -24,8 +24,19 @@
 
 #include "thread_manager.h"
 #include <atomic>
+#include <chrono>
 #include <iostream>
 
+namespace
+{
+    //-- Clamp a duration to a non-negative count of nanoseconds.
+    std::uint64_t to_nanoseconds(std::chrono::steady_clock::duration duration)
+    {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        return (ns > 0) ? static_cast<std::uint64_t>(ns) : 0;
+    }
+}
+
 ThreadManager::ThreadManager()
 {
     //-- Ensure we've empty control containers.
@@ -34,6 +45,15 @@ ThreadManager::ThreadManager()
 
     //-- Set the state of running.
     running = true;
+
+    //-- Loop timing output is opt-in.
+    debug = false;
+
+    //-- One task worker per hardware thread unless told otherwise.
+    task_workers = 0;
+
+    //-- Handle IDs start at 1, so 0 never names a handle.
+    next_handle_id = 1;
 }
 
 ThreadManager::~ThreadManager()
@@ -42,42 +62,177 @@ ThreadManager::~ThreadManager()
     this->close();
 }
 
-std::thread::id ThreadManager::add_thread(const std::function<void()> &func, bool start)
+std::shared_ptr<ThreadHandle> ThreadManager::add_thread(const std::function<void()> &func, bool start,
+                                                        const ThreadOptions &options)
 {
+    //-- Create the handle first, so its state exists before the thread runs.
+    auto handle = std::make_shared<ThreadHandle>(start);
+    handle->thread_name = options.name;
+
     //-- Lock the mutex to ensure read/write atomicity.
     lock.lock();
 
-    //-- Spawn a thread with the provided function.
-    pool.emplace_back(func); // Constructs std::thread directly in place
+    //-- Spawn a thread that applies its options, then runs the provided function.
+    pool.emplace_back([func, options]
+                      {
+                          apply_thread_options(options);
+                          func(); });
 
-    //-- Get this threads id, and set it's state to the input boolean.
-    std::thread::id thread_id = pool[pool.size() - 1].get_id();
-    status[thread_id] = start;
+    //-- Record this threads id and keep the handle alongside the thread.
+    handle->thread_id = pool.back().get_id();
+    handle->handle_id = next_handle_id++;
+    status.push_back(handle);
 
     //-- Unlock the mutex and return.
     lock.unlock();
 
-    //-- Return the thread id to the caller.
-    return thread_id;
+    //-- Return the thread handle to the caller.
+    return handle;
 }
 
-std::thread::id ThreadManager::add_loop_thread(const std::function<void()> &func, double period, bool start)
+std::shared_ptr<ThreadHandle> ThreadManager::add_loop_thread(const std::function<void()> &func, double period,
+                                                             bool start, OverrunPolicy policy,
+                                                             const ThreadOptions &options)
 {
+    //-- Create the handle first, so its state exists before the thread runs.
+    auto handle = std::make_shared<ThreadHandle>(start);
+    handle->thread_name = options.name;
+    handle->is_loop = true;
+
     //-- Lock the mutex to ensure read/write atomicity.
     lock.lock();
 
-    //-- Spawn a thread with the looper wrapper, taking the provided function and the looping period.
-    pool.emplace_back(&ThreadManager::looper_wrapper, this, func, period);
+    //-- Spawn a thread with the looper wrapper, taking its handle, the provided function and the looping period.
+    pool.emplace_back(&ThreadManager::looper_wrapper, this, handle, func, period, policy, options);
 
-    //-- Get this threads id, and set it's state to the input boolean.
-    std::thread::id thread_id = pool[pool.size() - 1].get_id();
-    status[thread_id] = start;
+    //-- Record this threads id and keep the handle alongside the thread.
+    handle->thread_id = pool.back().get_id();
+    handle->handle_id = next_handle_id++;
+    status.push_back(handle);
 
     //-- Unlock the mutex and return.
     lock.unlock();
 
-    //-- Return the thread id to the caller.
-    return thread_id;
+    //-- Return the thread handle to the caller.
+    return handle;
+}
+
+std::shared_ptr<ThreadHandle> ThreadManager::add_timer_loop(const std::function<void()> &func, double period,
+                                                            bool start, OverrunPolicy policy, const std::string &name)
+{
+    auto handle = std::make_shared<ThreadHandle>(false);
+    handle->thread_name = name;
+    handle->is_loop = true;
+    handle->is_timer = true;
+
+    TimerWheel &wheel = this->get_timer_wheel();
+    const auto step = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(period));
+
+    //-- Same bookkeeping as looper_wrapper, but the wheel decides when to call. The manager
+    //-- keeps the handle until the wheel is gone, so the callback need not own it.
+    ThreadHandle *loop = handle.get();
+    auto callback = [loop, func, step]
+    {
+        if (!loop->get_status())
+        {
+            return;
+        }
+
+        auto deadline = TimerWheel::scheduled_time();
+        auto start = std::chrono::steady_clock::now();
+        loop->loop_stats.jitter.record(to_nanoseconds(start - deadline));
+
+        func();
+
+        auto now = std::chrono::steady_clock::now();
+        loop->loop_stats.execution.record(to_nanoseconds(now - start));
+        if (now > deadline + step)
+        {
+            loop->loop_stats.overruns.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    //-- A paused loop has no timer, so it costs the wheel nothing. Resuming starts a new
+    //-- schedule one period later; the paused periods are not owed.
+    handle->reschedule = [&wheel, callback, period, policy, timer = TimerWheel::TimerId{0}](bool status) mutable
+    {
+        if (status && timer == 0)
+        {
+            timer = wheel.schedule_every(period, callback, policy);
+        }
+        else if (!status && timer != 0)
+        {
+            wheel.cancel(timer);
+            timer = 0;
+        }
+    };
+
+    //-- Lock the mutex to ensure read/write atomicity.
+    lock.lock();
+
+    handle->thread_id = wheel.get_id();
+    handle->handle_id = next_handle_id++;
+    status.push_back(handle);
+
+    //-- Unlock the mutex and return.
+    lock.unlock();
+
+    handle->set_status(start);
+
+    return handle;
+}
+
+TimerWheel &ThreadManager::get_timer_wheel()
+{
+    //-- Lock the mutex to ensure read/write atomicity.
+    lock.lock();
+
+    //-- Only spawn the wheel thread once somebody schedules on it.
+    if (!timers)
+    {
+        timers = std::make_unique<TimerWheel>();
+    }
+
+    TimerWheel &wheel_ref = *timers;
+
+    //-- Unlock the mutex and return.
+    lock.unlock();
+
+    return wheel_ref;
+}
+
+std::future<void> ThreadManager::spawn(Task task)
+{
+    return ::spawn(this->get_timer_wheel(), std::move(task));
+}
+
+Delay ThreadManager::delay(double seconds)
+{
+    return Delay(this->get_timer_wheel(), seconds);
+}
+
+TaskPool &ThreadManager::get_task_pool()
+{
+    //-- Lock the mutex to ensure read/write atomicity.
+    lock.lock();
+
+    //-- Only spawn the workers once somebody actually submits work.
+    if (!tasks)
+    {
+        tasks = std::make_unique<TaskPool>(task_workers);
+    }
+
+    TaskPool &pool_ref = *tasks;
+
+    //-- Unlock the mutex and return.
+    lock.unlock();
+
+    return pool_ref;
+}
+
+void ThreadManager::set_task_workers(std::size_t num_workers)
+{
+    task_workers = num_workers;
 }
 
 void ThreadManager::interrupt_thread(std::thread::id thread_id)
@@ -85,8 +240,33 @@ void ThreadManager::interrupt_thread(std::thread::id thread_id)
     //-- Lock the mutex to ensure read/write atomicity.
     lock.lock();
 
-    //-- Try interrupting this thread.
-    status[thread_id] = false;
+    //-- Try interrupting this thread; timer loops only share the wheel's.
+    for (auto &handle : status)
+    {
+        if (handle->thread_id == thread_id && !handle->is_timer)
+        {
+            handle->set_status(false);
+        }
+    }
+
+    //-- Unlock the mutex and return.
+    lock.unlock();
+}
+
+void ThreadManager::interrupt_handle(std::uint64_t handle_id)
+{
+    //-- Lock the mutex to ensure read/write atomicity.
+    lock.lock();
+
+    //-- Try interrupting this handle.
+    for (auto &handle : status)
+    {
+        if (handle->handle_id == handle_id)
+        {
+            handle->set_status(false);
+            break;
+        }
+    }
 
     //-- Unlock the mutex and return.
     lock.unlock();
@@ -94,13 +274,20 @@ void ThreadManager::interrupt_thread(std::thread::id thread_id)
 
 bool ThreadManager::get_thread_status(std::thread::id thread_id)
 {
-    // TODO: Maybe don't lock here.. just return the status.
+    bool thread_status = false;
 
-    //-- Lock the mutex to ensure read/write atomicity.
+    //-- Lock the mutex while searching, the flag itself needs no lock.
     lock.lock();
 
     //-- Get the status of this thread.
-    bool thread_status = status[thread_id];
+    for (auto &handle : status)
+    {
+        if (handle->thread_id == thread_id && !handle->is_timer)
+        {
+            thread_status = handle->get_status();
+            break;
+        }
+    }
 
     //-- Unlock the mutex and return.
     lock.unlock();
@@ -113,6 +300,32 @@ bool ThreadManager::get_manager_running()
     return running;
 }
 
+std::vector<LoopStatsSnapshot> ThreadManager::stats()
+{
+    std::vector<LoopStatsSnapshot> snapshots;
+
+    //-- Lock the mutex to ensure read/write atomicity.
+    lock.lock();
+
+    for (auto &handle : status)
+    {
+        if (handle->is_loop)
+        {
+            snapshots.push_back(handle->get_stats());
+        }
+    }
+
+    //-- Unlock the mutex and return.
+    lock.unlock();
+
+    return snapshots;
+}
+
+void ThreadManager::set_debug(bool enable)
+{
+    debug = enable;
+}
+
 void ThreadManager::start()
 {
     if (this->get_manager_running())
@@ -131,8 +344,17 @@ void ThreadManager::close()
     //-- Stop all the threads.
     this->stop();
 
-    //-- Tell the threads to stop running.
+    //-- Tell the threads to stop running, and wake any that are paused or sleeping.
+    lock.lock();
     this->running = false;
+    for (auto &handle : status)
+    {
+        handle->wake();
+    }
+    lock.unlock();
+
+    //-- Release anyone blocked in wait().
+    this->running.notify_all();
 
     //-- Join all the threads.
     for (auto &idx : pool)
@@ -140,18 +362,28 @@ void ThreadManager::close()
         idx.join();
     }
 
+    //-- Handles may outlive the manager, so they must stop rescheduling before the wheel goes.
+    for (auto &handle : status)
+    {
+        std::lock_guard<std::mutex> guard(handle->signal_lock);
+        handle->reschedule = nullptr;
+    }
+
+    //-- Drop every timer loop and join the wheel thread.
+    timers.reset();
+
     //-- Destroy all elements in the pool and running.
     pool.clear();
     status.clear();
+
+    //-- Finish any queued jobs and join the task workers.
+    tasks.reset();
 }
 
 void ThreadManager::wait()
 {
-    //-- Wait for the thread manager to stop.
-    while (this->get_manager_running())
-    {
-        this->sleep_thread(0.5);
-    }
+    //-- Block until close() clears the running flag.
+    this->running.wait(true);
 }
 
 void ThreadManager::sleep_thread(double seconds)
@@ -165,51 +397,96 @@ void ThreadManager::set_thread_status(bool thread_status)
     //-- Lock the mutex to ensure read/write atomicity.
     lock.lock();
 
-    //-- Get an iterator to the start of the map.
-    auto it = status.begin();
-    while (it != status.end())
+    //-- Flip every flag; loop threads read them without taking this lock.
+    for (auto &handle : status)
     {
-        it->second = thread_status;
-        ++it;
+        handle->set_status(thread_status);
     }
 
     //-- Unlock the mutex and return.
     lock.unlock();
 }
 
-void ThreadManager::looper_wrapper(const std::function<void()> &func, double period)
+void ThreadManager::looper_wrapper(std::shared_ptr<ThreadHandle> handle, const std::function<void()> &func,
+                                   double period, OverrunPolicy policy, ThreadOptions options)
 {
+    using clock = std::chrono::steady_clock;
+
+    //-- Name, pin and prioritise this thread before it starts looping.
+    apply_thread_options(options);
+
     //-- Get the id for the current thread.
     const std::thread::id thread_id = std::this_thread::get_id();
 
+    //-- Deadlines are absolute, so time spent in func() never accumulates as drift.
+    const auto step = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(period));
+    auto deadline = clock::now();
+
     //-- Loop until it's time to shutdown.
     while (this->get_manager_running())
     {
-        //-- Get the clock time for now.
-        auto start = std::chrono::system_clock::now();
+        //-- Block while paused rather than spinning through the loop.
+        if (!handle->get_status())
+        {
+            std::unique_lock<std::mutex> guard(handle->signal_lock);
+            handle->signal.wait(guard, [&] { return handle->get_status() || !this->get_manager_running(); });
 
-        //-- Call the provided function if this thread is enabled.
-        if (this->get_thread_status(thread_id))
+            //-- Restart the schedule, the paused periods are not owed.
+            deadline = clock::now();
+            continue;
+        }
+
+        //-- Get the clock time for now, and how late this iteration starts.
+        auto start = clock::now();
+        if (step > clock::duration::zero())
         {
-            func();
+            handle->loop_stats.jitter.record(to_nanoseconds(start - deadline));
         }
 
-        //-- Sleep the thread for the remaining time of the period.
-        auto end = std::chrono::system_clock::now();
-        std::chrono::duration<double> dur = end - start;
-        double diff = period - dur.count();
+        //-- Call the provided function.
+        func();
+
+        //-- Work out the next deadline, handling any overrun.
+        deadline += step;
+        auto now = clock::now();
+        handle->loop_stats.execution.record(to_nanoseconds(now - start));
 
-        diff = (diff > 0.0) ? diff : 0.0;
+        if (now > deadline && step > clock::duration::zero())
+        {
+            handle->loop_stats.overruns.fetch_add(1, std::memory_order_relaxed);
+
+            if (policy == OverrunPolicy::WARN)
+            {
+                std::chrono::duration<double> late = now - deadline;
+                std::cerr << "[WARNING] Thread id ("
+                          << thread_id
+                          << ") overran its period by "
+                          << late.count()
+                          << " seconds.\n";
+            }
+
+            if (policy != OverrunPolicy::CATCH_UP)
+            {
+                //-- Move to the first deadline still ahead, keeping the original phase.
+                deadline += ((now - deadline) / step + 1) * step;
+            }
+        }
 
-        this->sleep_thread(diff);
+        //-- Sleep the thread until the start of the next period, waking early if the manager closes.
+        if (step > clock::duration::zero())
+        {
+            std::unique_lock<std::mutex> guard(handle->signal_lock);
+            handle->signal.wait_until(guard, deadline, [this] { return !this->get_manager_running(); });
+        }
 
-        auto loop_time = std::chrono::system_clock::now();
-        std::chrono::duration<double> loop_dur = loop_time - start;
-        std::cout << "[DEBUG] Thread id ("
-                  << thread_id
-                  << ") executed in "
-                  << loop_dur.count()
-                  << " seconds."
-                  << std::endl;
+        if (debug)
+        {
+            std::chrono::duration<double> loop_dur = clock::now() - start;
+            std::cout << "[DEBUG] Thread id ("
+                      << thread_id
+                      << ") executed in "
+                      << loop_dur.count()
+                      << " seconds.\n";
+        }
     }
 }
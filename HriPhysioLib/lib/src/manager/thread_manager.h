@@ -25,12 +25,177 @@
 #ifndef HRI_PHYSIO_MANAGER_THREAD_MANAGER_H
 #define HRI_PHYSIO_MANAGER_THREAD_MANAGER_H
 
+#include <condition_variable>
+#include <cstdint>
 #include <functional>
-#include <map>
 #include <thread>
 #include <vector>
 #include <atomic>
+#include <memory>
 #include <mutex>
+#include "coroutine.h"
+#include "loop_stats.h"
+#include "task_pool.h"
+#include "thread_options.h"
+#include "timer_wheel.h"
+#include "../utilities/enums.h"
+
+/**
+ * @class ThreadHandle
+ * @brief Stable per-thread state shared between the manager and the thread.
+ *
+ * The running flag is a single atomic, so loop threads check it with one
+ * relaxed load per iteration instead of taking the manager lock. A paused
+ * loop thread blocks on the handle's condition until it is resumed or the
+ * manager closes.
+ */
+class ThreadHandle
+{
+    /**
+     * Atomic flag to indicate if the thread should run its function.
+     */
+    std::atomic<bool> enabled;
+
+    /**
+     * ID of the managed thread.
+     */
+    std::thread::id thread_id;
+
+    /**
+     * ID of the handle, unique within its manager.
+     */
+    std::uint64_t handle_id = 0;
+
+    /**
+     * Name given in the thread's options, if any.
+     */
+    std::string thread_name;
+
+    /**
+     * Flag to indicate the thread runs under looper_wrapper and records timing.
+     */
+    bool is_loop = false;
+
+    /**
+     * Flag to indicate the loop runs on the timer wheel and shares its thread ID.
+     */
+    bool is_timer = false;
+
+    /**
+     * Schedules or cancels a timer loop's timer as its status changes, called
+     * with the signal lock held. Empty for threads and once the manager closes.
+     */
+    std::function<void(bool)> reschedule;
+
+    /**
+     * Timing counters, written only by the loop thread itself.
+     */
+    LoopStats loop_stats;
+
+    /**
+     * Mutex and condition used to wake the thread when its status changes.
+     */
+    std::mutex signal_lock;
+    std::condition_variable signal;
+
+    friend class ThreadManager;
+
+    /**
+     * Wakes the thread so it re-checks its status and the manager state.
+     */
+    void wake()
+    {
+        {
+            std::lock_guard<std::mutex> guard(signal_lock);
+        }
+        signal.notify_all();
+    }
+
+public:
+    /**
+     * Constructor to set the initial running status.
+     * @param start True if the thread should run immediately.
+     */
+    explicit ThreadHandle(bool start) : enabled(start) {}
+
+    /**
+     * Gets the running status of the thread.
+     * @return True if the thread is running, false otherwise.
+     */
+    [[nodiscard]] bool get_status() const
+    {
+        return enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Sets the running status of the thread.
+     * @param status True to run the thread, false to pause it.
+     */
+    void set_status(bool status)
+    {
+        {
+            std::lock_guard<std::mutex> guard(signal_lock);
+            enabled.store(status, std::memory_order_relaxed);
+            if (reschedule)
+            {
+                reschedule(status);
+            }
+        }
+        signal.notify_all();
+    }
+
+    /**
+     * Gets the ID of the managed thread.
+     * @return ID of the thread.
+     */
+    [[nodiscard]] std::thread::id get_id() const
+    {
+        return thread_id;
+    }
+
+    /**
+     * Gets the ID of the handle. Unlike the thread ID, it tells apart timer loops on the same wheel.
+     * @return ID of the handle.
+     */
+    [[nodiscard]] std::uint64_t get_handle_id() const
+    {
+        return handle_id;
+    }
+
+    /**
+     * Gets the name of the managed thread.
+     * @return Name from the thread's options, empty if none was given.
+     */
+    [[nodiscard]] const std::string &get_name() const
+    {
+        return thread_name;
+    }
+
+    /**
+     * Gets a copy of the loop timing counters. Safe to call while the loop runs.
+     * @return Execution time and jitter histograms and the overrun count.
+     */
+    [[nodiscard]] LoopStatsSnapshot get_stats() const
+    {
+        LoopStatsSnapshot snap;
+        snap.thread_id = thread_id;
+        snap.name = thread_name;
+        snap.execution = loop_stats.execution.snapshot();
+        snap.jitter = loop_stats.jitter.snapshot();
+        snap.overruns = loop_stats.overruns.load(std::memory_order_relaxed);
+        return snap;
+    }
+
+    /**
+     * Drops all recorded loop timing samples.
+     */
+    void reset_stats()
+    {
+        loop_stats.execution.reset();
+        loop_stats.jitter.reset();
+        loop_stats.overruns.store(0, std::memory_order_relaxed);
+    }
+};
 
 /**
  * @class ThreadManager
@@ -44,20 +209,45 @@ class ThreadManager
     std::vector<std::thread> pool;
 
     /**
-     * Map to track the running status of each thread.
+     * Handles tracking the running status of each thread, in pool order.
      */
-    std::map<std::thread::id, bool> status;
+    std::vector<std::shared_ptr<ThreadHandle>> status;
 
     /**
      * Atomic flag to indicate if the manager is running.
      */
     std::atomic<bool> running;
 
+    /**
+     * Atomic flag to print per-iteration timing of loop threads.
+     */
+    std::atomic<bool> debug;
+
     /**
      * Mutex for ensuring atomicity.
      */
     std::mutex lock;
 
+    /**
+     * Executor for short jobs, created on first use.
+     */
+    std::unique_ptr<TaskPool> tasks;
+
+    /**
+     * Number of task workers to create, 0 for one per hardware thread.
+     */
+    std::size_t task_workers;
+
+    /**
+     * Shared scheduler for periodic callbacks that do not need their own thread, created on first use.
+     */
+    std::unique_ptr<TimerWheel> timers;
+
+    /**
+     * ID given to the next handle.
+     */
+    std::uint64_t next_handle_id;
+
 public:
     /**
      * Constructor to initialize the ThreadManager.
@@ -73,27 +263,117 @@ public:
      * Adds a new thread to the pool.
      * @param func Function to be executed by the thread.
      * @param start Flag to indicate if the thread should start immediately.
-     * @return ID of the newly added thread.
+     * @param options Name, CPU affinity and scheduling applied by the thread when it starts.
+     * @return Handle of the newly added thread.
      */
-    std::thread::id add_thread(const std::function<void()> &func, bool start = true);
+    std::shared_ptr<ThreadHandle> add_thread(const std::function<void()> &func, bool start = true,
+                                             const ThreadOptions &options = ThreadOptions());
 
     /**
-     * Adds a new loop thread to the pool.
+     * Adds a new loop thread to the pool. Iterations are scheduled on absolute
+     * steady_clock deadlines, so the period does not drift with the work time.
      * @param func Function to be executed by the thread.
      * @param period Time period between each loop iteration.
      * @param start Flag to indicate if the thread should start immediately.
-     * @return ID of the newly added loop thread.
+     * @param policy What to do when an iteration overruns its next deadline.
+     * @param options Name, CPU affinity and scheduling applied by the thread when it starts.
+     * @return Handle of the newly added loop thread.
+     */
+    std::shared_ptr<ThreadHandle> add_loop_thread(const std::function<void(void)> &func, double period = 0.0, bool start = true,
+                                                  OverrunPolicy policy = OverrunPolicy::SKIP,
+                                                  const ThreadOptions &options = ThreadOptions());
+
+    /**
+     * Adds a loop that runs on the manager's timer wheel instead of its own
+     * thread. Suited to short callbacks at low rates, many of which can then
+     * share one thread. The handle behaves like that of add_loop_thread, but
+     * its thread ID is the wheel thread's, so tell loops apart by handle ID.
+     * A paused loop is taken off the wheel until it is resumed.
+     * @param func Function to be executed every period.
+     * @param period Time period between each loop iteration, greater than 0.
+     * @param start Flag to indicate if the loop should start immediately.
+     * @param policy What to do when an iteration overruns its next deadline.
+     * @param name Name reported in the loop's stats.
+     * @return Handle of the newly added loop.
+     */
+    std::shared_ptr<ThreadHandle> add_timer_loop(const std::function<void(void)> &func, double period, bool start = true,
+                                                 OverrunPolicy policy = OverrunPolicy::SKIP,
+                                                 const std::string &name = "");
+
+    /**
+     * Gets the timer wheel, spawning its thread on first use.
+     * @return The manager's timer wheel.
      */
-    std::thread::id add_loop_thread(const std::function<void(void)> &func, double period = 0.0, bool start = true);
+    TimerWheel &get_timer_wheel();
 
     /**
-     * Interrupts a thread by its ID.
+     * Starts a coroutine on the timer wheel. The coroutine may co_await
+     * delay() and DataEvent values; while it waits, no thread is blocked.
+     * All coroutines share the wheel thread and never run concurrently.
+     * @param task Coroutine to start.
+     * @return Future that completes when the coroutine returns or throws.
+     */
+    std::future<void> spawn(Task task);
+
+    /**
+     * Creates an awaitable that resumes a spawned coroutine after a delay.
+     * @param seconds Delay in seconds.
+     * @return Awaitable for co_await.
+     */
+    Delay delay(double seconds);
+
+    /**
+     * Queues a short job on the manager's work-stealing task pool.
+     * @param func Callable taking no arguments.
+     * @return Future holding the result of the job.
+     */
+    template <class Func>
+    auto submit(Func &&func)
+    {
+        return this->get_task_pool().submit(std::forward<Func>(func));
+    }
+
+    /**
+     * Runs func(idx) for every idx in [begin, end) on the task pool and waits for all of them.
+     * @param begin First index.
+     * @param end One past the last index.
+     * @param func Callable taking a std::size_t.
+     * @param grain Indices per task, 0 to pick one from the pool size.
+     */
+    template <class Func>
+    void parallel_for(std::size_t begin, std::size_t end, Func &&func, std::size_t grain = 0)
+    {
+        this->get_task_pool().parallel_for(begin, end, std::forward<Func>(func), grain);
+    }
+
+    /**
+     * Gets the task pool, spawning its workers on first use.
+     * @return The manager's task pool.
+     */
+    TaskPool &get_task_pool();
+
+    /**
+     * Sets the number of task pool workers. Only has an effect before the pool is first used.
+     * @param num_workers Number of workers, 0 for one per hardware thread.
+     */
+    void set_task_workers(std::size_t num_workers);
+
+    /**
+     * Interrupts a thread by its ID. Timer loops do not own their thread and are left alone.
      * @param thread_id ID of the thread to be interrupted.
      */
     void interrupt_thread(std::thread::id thread_id);
 
     /**
-     * Gets the running status of a thread.
+     * Interrupts a thread or timer loop by the ID of its handle.
+     * @param handle_id ID of the handle to be interrupted.
+     */
+    void interrupt_handle(std::uint64_t handle_id);
+
+    /**
+     * Gets the running status of a thread by its ID. Loop threads check their
+     * handle directly; this lookup is for callers that only have the ID.
+     * Timer loops do not own their thread and are not matched.
      * @param thread_id ID of the thread.
      * @return True if the thread is running, false otherwise.
      */
@@ -105,6 +385,18 @@ public:
      */
     bool get_manager_running();
 
+    /**
+     * Gets the timing counters of every loop thread.
+     * @return One snapshot per loop thread, in the order they were added.
+     */
+    std::vector<LoopStatsSnapshot> stats();
+
+    /**
+     * Enables or disables per-iteration timing output of loop threads.
+     * @param enable True to print a line per loop iteration.
+     */
+    void set_debug(bool enable);
+
     /**
      * Starts the manager.
      */
@@ -116,12 +408,13 @@ public:
     void stop();
 
     /**
-     * Closes the manager and cleans up resources.
+     * Closes the manager and cleans up resources. Paused and sleeping loop
+     * threads are woken, so this returns as soon as their current iteration ends.
      */
     void close();
 
     /**
-     * Waits for all threads to finish.
+     * Blocks until the manager is closed.
      */
     void wait();
 
@@ -141,10 +434,14 @@ private:
 
     /**
      * Wrapper function for loop threads.
+     * @param handle Handle holding the running status of this thread.
      * @param func Function to be executed by the thread.
      * @param period Time period between each loop iteration.
+     * @param policy What to do when an iteration overruns its next deadline.
+     * @param options Options to apply before the first iteration.
      */
-    void looper_wrapper(const std::function<void(void)> &func, double period);
+    void looper_wrapper(std::shared_ptr<ThreadHandle> handle, const std::function<void(void)> &func, double period,
+                        OverrunPolicy policy, ThreadOptions options);
 
 public:
     // Disallow copy and assignment operators.
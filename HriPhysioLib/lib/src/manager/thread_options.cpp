@@ -0,0 +1,144 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Vedika Chauhan,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Vedika Chauhan <vedika.chauhan@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+
+#include "thread_options.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <yaml-cpp/yaml.h>
+#include "../utilities/helpers.h"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#elif defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+ThreadOptions ThreadOptions::from_yaml(const YAML::Node &node, const std::string &fallback_name)
+{
+    ThreadOptions options;
+    options.name = fallback_name;
+
+    if (!node || !node.IsMap())
+    {
+        return options;
+    }
+
+    options.name = node["name"].as<std::string>(fallback_name);
+    options.cpus = node["cpus"].as<std::vector<int>>(std::vector<int>());
+    options.priority = node["priority"].as<int>(0);
+
+    std::string scheduling = node["scheduling"].as<std::string>("default");
+    scheduling = to_lowercase(scheduling);
+    if (scheduling == "fifo")
+    {
+        options.scheduling = SchedulingPolicy::FIFO;
+    }
+    else if (scheduling == "rr")
+    {
+        options.scheduling = SchedulingPolicy::ROUND_ROBIN;
+    }
+    else if (scheduling != "default")
+    {
+        std::cerr << "[WARNING] Unknown scheduling policy \"" << scheduling
+                  << "\" for thread " << options.name << ", using default.\n";
+    }
+
+    return options;
+}
+
+bool apply_thread_options(const ThreadOptions &options)
+{
+    bool applied = true;
+
+#ifdef __linux__
+    pthread_t self = pthread_self();
+
+    //-- Linux limits names to 15 characters plus the terminator.
+    if (!options.name.empty())
+    {
+        const std::string name = options.name.substr(0, 15);
+        if (pthread_setname_np(self, name.c_str()) != 0)
+        {
+            applied = false;
+        }
+    }
+
+    if (!options.cpus.empty())
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : options.cpus)
+        {
+            if (cpu >= 0 && cpu < CPU_SETSIZE)
+            {
+                CPU_SET(cpu, &set);
+            }
+        }
+
+        int err = pthread_setaffinity_np(self, sizeof(set), &set);
+        if (err != 0)
+        {
+            std::cerr << "[WARNING] Could not set CPU affinity of thread " << options.name
+                      << ": " << std::strerror(err) << ".\n";
+            applied = false;
+        }
+    }
+
+    if (options.scheduling != SchedulingPolicy::DEFAULT)
+    {
+        const int policy = (options.scheduling == SchedulingPolicy::FIFO) ? SCHED_FIFO : SCHED_RR;
+
+        sched_param param{};
+        param.sched_priority = std::clamp(options.priority,
+                                          sched_get_priority_min(policy),
+                                          sched_get_priority_max(policy));
+
+        int err = pthread_setschedparam(self, policy, &param);
+        if (err == EPERM)
+        {
+            std::cerr << "[WARNING] Thread " << options.name
+                      << " may not use real-time scheduling (needs CAP_SYS_NICE or an rtprio limit),"
+                      << " keeping the default scheduler.\n";
+            applied = false;
+        }
+        else if (err != 0)
+        {
+            std::cerr << "[WARNING] Could not set scheduling of thread " << options.name
+                      << ": " << std::strerror(err) << ".\n";
+            applied = false;
+        }
+    }
+#else
+#ifdef __APPLE__
+    //-- macOS only names the calling thread; keep the Linux limit so names match across platforms.
+    if (!options.name.empty())
+    {
+        const std::string name = options.name.substr(0, 15);
+        if (pthread_setname_np(name.c_str()) != 0)
+        {
+            applied = false;
+        }
+    }
+#endif
+
+    if (!options.cpus.empty() || options.scheduling != SchedulingPolicy::DEFAULT)
+    {
+        std::cerr << "[WARNING] Thread affinity and real-time scheduling are only supported on Linux.\n";
+        applied = false;
+    }
+#endif
+
+    return applied;
+}
@@ -0,0 +1,73 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Vedika Chauhan,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Vedika Chauhan <vedika.chauhan@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+
+#ifndef HRI_PHYSIO_MANAGER_THREAD_OPTIONS_H
+#define HRI_PHYSIO_MANAGER_THREAD_OPTIONS_H
+
+#include <string>
+#include <vector>
+#include "../utilities/enums.h"
+
+namespace YAML
+{
+    class Node;
+}
+
+/**
+ * @struct ThreadOptions
+ * @brief OS-level settings applied by a managed thread when it starts.
+ *
+ * Every field is optional; the defaults leave the thread exactly as
+ * std::thread created it.
+ */
+struct ThreadOptions
+{
+    /**
+     * Thread name shown by top/htop/gdb, truncated to 15 characters.
+     */
+    std::string name;
+
+    /**
+     * CPUs the thread may run on, empty for no restriction.
+     */
+    std::vector<int> cpus;
+
+    /**
+     * Scheduling policy of the thread.
+     */
+    SchedulingPolicy scheduling = SchedulingPolicy::DEFAULT;
+
+    /**
+     * Real-time priority, clamped to the range of the policy. Ignored for DEFAULT.
+     */
+    int priority = 0;
+
+    /**
+     * Reads options from a YAML map with the optional keys name, cpus,
+     * scheduling (default, fifo or rr) and priority.
+     * @param node YAML map; a missing or null node gives the defaults.
+     * @param fallback_name Name to use when the node does not set one.
+     * @return Parsed options.
+     */
+    static ThreadOptions from_yaml(const YAML::Node &node, const std::string &fallback_name = "");
+};
+
+/**
+ * Applies options to the calling thread. Settings the process may not
+ * change, e.g. a real-time policy without CAP_SYS_NICE, are skipped with a
+ * warning and the thread keeps running with the defaults.
+ * @param options Options to apply.
+ * @return True if every requested setting was applied, false otherwise.
+ */
+bool apply_thread_options(const ThreadOptions &options);
+
+#endif /* HRI_PHYSIO_MANAGER_THREAD_OPTIONS_H */
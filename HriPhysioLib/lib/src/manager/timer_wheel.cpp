@@ -0,0 +1,306 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Vedika Chauhan,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Vedika Chauhan <vedika.chauhan@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+
+#include "timer_wheel.h"
+#include <bit>
+#include <iostream>
+
+namespace
+{
+    //-- Deadline of the callback running on this thread.
+    thread_local TimerWheel::clock::time_point current_deadline;
+}
+
+TimerWheel::TimerWheel(double resolution) : occupied{},
+                                            origin(clock::now()),
+                                            tick(std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(resolution))),
+                                            current_tick(0),
+                                            next_id(1),
+                                            running(true)
+{
+    if (tick <= clock::duration::zero())
+    {
+        tick = clock::duration(1);
+    }
+
+    worker = std::thread(&TimerWheel::run, this);
+}
+
+TimerWheel::~TimerWheel()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        running = false;
+    }
+    changed.notify_all();
+
+    worker.join();
+}
+
+TimerWheel::TimerId TimerWheel::schedule_once(double delay, std::function<void()> func)
+{
+    return add_timer(delay, 0.0, std::move(func), OverrunPolicy::SKIP);
+}
+
+TimerWheel::TimerId TimerWheel::schedule_every(double period, std::function<void()> func, OverrunPolicy policy)
+{
+    return add_timer(period, period, std::move(func), policy);
+}
+
+TimerWheel::TimerId TimerWheel::add_timer(double delay, double period, std::function<void()> func,
+                                          OverrunPolicy policy)
+{
+    auto timer = std::make_shared<Timer>();
+    timer->period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(period));
+    timer->deadline = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(delay));
+    timer->policy = policy;
+    timer->func = std::move(func);
+
+    std::unique_lock<std::mutex> guard(lock);
+    const TimerId id = next_id++;
+    timers.emplace(id, timer);
+    insert(id, timer->deadline);
+    guard.unlock();
+
+    //-- The new timer may be due before the thread planned to wake.
+    changed.notify_one();
+    return id;
+}
+
+bool TimerWheel::cancel(TimerId id)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return timers.erase(id) != 0;
+}
+
+std::size_t TimerWheel::size()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return timers.size();
+}
+
+double TimerWheel::resolution() const
+{
+    return std::chrono::duration<double>(tick).count();
+}
+
+std::thread::id TimerWheel::get_id() const
+{
+    return worker.get_id();
+}
+
+TimerWheel::clock::time_point TimerWheel::scheduled_time()
+{
+    return current_deadline;
+}
+
+std::uint64_t TimerWheel::to_tick(clock::time_point time) const
+{
+    if (time <= origin)
+    {
+        return 0;
+    }
+    return static_cast<std::uint64_t>((time - origin + tick - clock::duration(1)) / tick);
+}
+
+void TimerWheel::insert(TimerId id, clock::time_point deadline)
+{
+    //-- Anything already due goes in the slot processed next.
+    std::uint64_t expiry = std::max(to_tick(deadline), current_tick);
+    const std::uint64_t delta = expiry - current_tick;
+
+    unsigned level = 0;
+    while (level + 1 < num_levels && delta >= (std::uint64_t{1} << (slot_bits * (level + 1))))
+    {
+        ++level;
+    }
+
+    //-- Beyond the range of the top level, park in its furthest slot and re-insert on cascade.
+    const std::uint64_t range = std::uint64_t{1} << (slot_bits * num_levels);
+    if (delta >= range)
+    {
+        expiry = current_tick + range - 1;
+    }
+
+    const std::size_t slot = (expiry >> (slot_bits * level)) & (num_slots - 1);
+    wheel[level][slot].push_back(id);
+    occupied[level] |= std::uint64_t{1} << slot;
+}
+
+void TimerWheel::cascade(unsigned level)
+{
+    const std::size_t slot = (current_tick >> (slot_bits * level)) & (num_slots - 1);
+
+    std::vector<TimerId> ids;
+    ids.swap(wheel[level][slot]);
+    occupied[level] &= ~(std::uint64_t{1} << slot);
+
+    for (TimerId id : ids)
+    {
+        auto it = timers.find(id);
+        if (it != timers.end())
+        {
+            insert(id, it->second->deadline);
+        }
+    }
+}
+
+bool TimerWheel::next_tick(std::uint64_t &next, bool earliest) const
+{
+    bool found = false;
+
+    //-- Level 0 holds exact ticks within the next 64.
+    if (occupied[0] != 0)
+    {
+        const unsigned start = current_tick & (num_slots - 1);
+        next = current_tick + std::countr_zero(std::rotr(occupied[0], static_cast<int>(start)));
+        found = true;
+    }
+
+    //-- Higher levels need a wake-up at the start of their next occupied block, to cascade.
+    for (unsigned level = 1; level < num_levels; ++level)
+    {
+        if (occupied[level] == 0)
+        {
+            continue;
+        }
+
+        const unsigned shift = slot_bits * level;
+        const std::uint64_t block = (current_tick >> shift) + 1;
+        const unsigned start = block & (num_slots - 1);
+        const unsigned offset = std::countr_zero(std::rotr(occupied[level], static_cast<int>(start)));
+        std::uint64_t level_tick = (block + offset) << shift;
+
+        //-- The walk cascades on its way past, so sleeping straight to the earliest deadline is enough.
+        if (earliest)
+        {
+            std::uint64_t first = ~std::uint64_t{0};
+            for (TimerId id : wheel[level][(start + offset) & (num_slots - 1)])
+            {
+                auto it = timers.find(id);
+                if (it != timers.end())
+                {
+                    first = std::min(first, to_tick(it->second->deadline));
+                }
+            }
+            level_tick = std::max(level_tick, first == ~std::uint64_t{0} ? level_tick : first);
+        }
+
+        if (!found || level_tick < next)
+        {
+            next = level_tick;
+            found = true;
+        }
+    }
+
+    return found;
+}
+
+void TimerWheel::run()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    std::vector<TimerId> due;
+
+    while (running)
+    {
+        //-- Walk every tick up to now, collecting expired timers in deadline order.
+        const auto elapsed = clock::now() - origin;
+        const std::uint64_t now_tick = static_cast<std::uint64_t>(elapsed / tick);
+        while (current_tick <= now_tick)
+        {
+            if ((current_tick & (num_slots - 1)) == 0)
+            {
+                for (unsigned level = 1; level < num_levels; ++level)
+                {
+                    cascade(level);
+                    if (((current_tick >> (slot_bits * level)) & (num_slots - 1)) != 0)
+                    {
+                        break;
+                    }
+                }
+            }
+
+            const std::size_t slot = current_tick & (num_slots - 1);
+            due.insert(due.end(), wheel[0][slot].begin(), wheel[0][slot].end());
+            wheel[0][slot].clear();
+            occupied[0] &= ~(std::uint64_t{1} << slot);
+
+            ++current_tick;
+
+            //-- Jump over ticks with nothing to fire or cascade.
+            std::uint64_t next = 0;
+            if (!next_tick(next, false) || next > now_tick)
+            {
+                next = now_tick + 1;
+            }
+            current_tick = std::max(current_tick, next);
+        }
+
+        //-- Run the callbacks without holding the lock, so they may schedule or cancel timers.
+        for (TimerId id : due)
+        {
+            auto it = timers.find(id);
+            if (it == timers.end())
+            {
+                continue;
+            }
+
+            std::shared_ptr<Timer> timer = it->second;
+            if (timer->period <= clock::duration::zero())
+            {
+                timers.erase(it);
+            }
+
+            guard.unlock();
+            current_deadline = timer->deadline;
+            timer->func();
+            guard.lock();
+
+            //-- Periodic timers that were not cancelled meanwhile go back in, one period on.
+            if (timer->period > clock::duration::zero() && timers.count(id) != 0)
+            {
+                timer->deadline += timer->period;
+
+                const auto now = clock::now();
+                if (timer->deadline <= now && timer->policy != OverrunPolicy::CATCH_UP)
+                {
+                    const auto missed = (now - timer->deadline) / timer->period + 1;
+                    if (timer->policy == OverrunPolicy::WARN)
+                    {
+                        std::cerr << "[WARNING] Timer " << id << " missed " << missed << " period(s).\n";
+                    }
+                    timer->deadline += missed * timer->period;
+                }
+
+                insert(id, timer->deadline);
+            }
+        }
+        due.clear();
+
+        //-- The destructor may have stopped the wheel while a callback ran, and its notify is gone.
+        if (!running)
+        {
+            break;
+        }
+
+        //-- Sleep until the next occupied slot, or until the wheel changes.
+        std::uint64_t next = 0;
+        if (next_tick(next, true))
+        {
+            changed.wait_until(guard, origin + next * tick);
+        }
+        else
+        {
+            changed.wait(guard);
+        }
+    }
+}
@@ -0,0 +1,261 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Vedika Chauhan,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Vedika Chauhan <vedika.chauhan@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+
+#ifndef HRI_PHYSIO_MANAGER_TIMER_WHEEL_H
+#define HRI_PHYSIO_MANAGER_TIMER_WHEEL_H
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "../utilities/enums.h"
+
+/**
+ * @class TimerWheel
+ * @brief Runs many one-shot and periodic callbacks on a single thread.
+ *
+ * Timers are kept in a hierarchical wheel of 4 levels with 64 slots each. A
+ * slot on level L covers 64^L ticks, so scheduling and cancelling are O(1),
+ * and timers move down a level only when their slot comes up. The thread
+ * sleeps until the earliest deadline rather than waking on every tick, and
+ * skips over empty stretches of the wheel when it wakes.
+ * Callbacks fire no earlier than their deadline and at most one tick plus
+ * the wake-up latency after it. All callbacks share the wheel thread, so
+ * they should be short; anything heavy belongs on the TaskPool.
+ */
+class TimerWheel
+{
+public:
+    /**
+     * Clock used for all deadlines.
+     */
+    using clock = std::chrono::steady_clock;
+
+    /**
+     * Identifier of a scheduled timer.
+     */
+    using TimerId = std::uint64_t;
+
+private:
+    /**
+     * Number of bits of the tick count consumed per level.
+     */
+    static constexpr unsigned slot_bits = 6;
+
+    /**
+     * Number of slots per level.
+     */
+    static constexpr std::size_t num_slots = std::size_t{1} << slot_bits;
+
+    /**
+     * Number of levels in the wheel.
+     */
+    static constexpr unsigned num_levels = 4;
+
+    /**
+     * @struct Timer
+     * @brief A scheduled callback.
+     */
+    struct Timer
+    {
+        /**
+         * Exact time the callback is due.
+         */
+        clock::time_point deadline;
+
+        /**
+         * Time between firings, zero for a one-shot timer.
+         */
+        clock::duration period;
+
+        /**
+         * What to do when a periodic callback falls behind its schedule.
+         */
+        OverrunPolicy policy;
+
+        /**
+         * Callback to run.
+         */
+        std::function<void()> func;
+    };
+
+    /**
+     * Live timers by id. Cancelled ids stay in their slot until it comes up.
+     */
+    std::unordered_map<TimerId, std::shared_ptr<Timer>> timers;
+
+    /**
+     * Timer ids per level and slot.
+     */
+    std::array<std::array<std::vector<TimerId>, num_slots>, num_levels> wheel;
+
+    /**
+     * One bit per non-empty slot, per level.
+     */
+    std::array<std::uint64_t, num_levels> occupied;
+
+    /**
+     * Time of tick zero.
+     */
+    clock::time_point origin;
+
+    /**
+     * Duration of one tick.
+     */
+    clock::duration tick;
+
+    /**
+     * Next tick to be processed.
+     */
+    std::uint64_t current_tick;
+
+    /**
+     * Id handed to the next scheduled timer.
+     */
+    TimerId next_id;
+
+    /**
+     * Flag to indicate if the wheel thread should keep running.
+     */
+    bool running;
+
+    /**
+     * Mutex guarding the wheel, and condition to wake the thread on changes.
+     */
+    std::mutex lock;
+    std::condition_variable changed;
+
+    /**
+     * The wheel thread.
+     */
+    std::thread worker;
+
+public:
+    /**
+     * Constructor to start the wheel thread.
+     * @param resolution Duration of one tick in seconds.
+     */
+    explicit TimerWheel(double resolution = 100e-6);
+
+    /**
+     * Destructor drops all timers and joins the wheel thread.
+     */
+    ~TimerWheel();
+
+    /**
+     * Runs a callback once after a delay.
+     * @param delay Delay in seconds.
+     * @param func Callback to run on the wheel thread.
+     * @return Id of the timer.
+     */
+    TimerId schedule_once(double delay, std::function<void()> func);
+
+    /**
+     * Runs a callback every period, starting one period from now. Deadlines
+     * are absolute, so the schedule does not drift with callback run time.
+     * @param period Period in seconds.
+     * @param func Callback to run on the wheel thread.
+     * @param policy What to do when the callback falls behind its schedule.
+     * @return Id of the timer.
+     */
+    TimerId schedule_every(double period, std::function<void()> func, OverrunPolicy policy = OverrunPolicy::SKIP);
+
+    /**
+     * Cancels a timer. A callback that is already running finishes.
+     * @param id Id of the timer.
+     * @return True if the timer was live, false otherwise.
+     */
+    bool cancel(TimerId id);
+
+    /**
+     * Gets the number of live timers.
+     * @return Number of timers.
+     */
+    std::size_t size();
+
+    /**
+     * Gets the duration of one tick.
+     * @return Resolution in seconds.
+     */
+    [[nodiscard]] double resolution() const;
+
+    /**
+     * Gets the ID of the wheel thread, on which all callbacks run.
+     * @return ID of the thread.
+     */
+    [[nodiscard]] std::thread::id get_id() const;
+
+    /**
+     * Gets the deadline of the callback running on the calling thread.
+     * @return Deadline of the current callback, only meaningful inside one.
+     */
+    static clock::time_point scheduled_time();
+
+private:
+    /**
+     * Create a timer and add it to the wheel.
+     * @param delay Seconds until the first firing.
+     * @param period Seconds between firings, 0 for a one-shot timer.
+     * @param func Callback to run on the wheel thread.
+     * @param policy What to do when the callback falls behind its schedule.
+     * @return Id of the timer.
+     */
+    TimerId add_timer(double delay, double period, std::function<void()> func, OverrunPolicy policy);
+
+    /**
+     * Convert a time to the first tick at or after it.
+     * @param time Time to convert.
+     * @return Tick count.
+     */
+    [[nodiscard]] std::uint64_t to_tick(clock::time_point time) const;
+
+    /**
+     * Add a timer to the wheel. The caller must hold the lock.
+     * @param id Id of the timer.
+     * @param deadline Time the timer is due.
+     */
+    void insert(TimerId id, clock::time_point deadline);
+
+    /**
+     * Re-insert the timers of the current slot of a level, moving them
+     * closer to level 0. The caller must hold the lock.
+     * @param level Level to cascade, at least 1.
+     */
+    void cascade(unsigned level);
+
+    /**
+     * Find the next tick that needs attention. The caller must hold the lock.
+     * @param next Destination for the tick.
+     * @param earliest True to look inside the next occupied higher-level slot
+     *     for its earliest deadline, false to stop at the tick it cascades on.
+     * @return True if any slot is occupied, false otherwise.
+     */
+    bool next_tick(std::uint64_t &next, bool earliest) const;
+
+    /**
+     * Main loop of the wheel thread.
+     */
+    void run();
+
+public:
+    // Disallow copy and assignment operators.
+    TimerWheel(const TimerWheel &) = delete;
+    TimerWheel &operator=(const TimerWheel &) = delete;
+};
+
+#endif /* HRI_PHYSIO_MANAGER_TIMER_WHEEL_H */
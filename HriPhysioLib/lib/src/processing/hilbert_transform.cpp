@@ -32,6 +32,11 @@ HilbertTransform::HilbertTransform(std::size_t samples)
 HilbertTransform::~HilbertTransform() = default;
 
 void HilbertTransform::process(const std::vector<double> &source, std::vector<double> &target)
+{
+    this->process(std::span<const double>(source), target);
+}
+
+void HilbertTransform::process(std::span<const double> source, std::vector<double> &target)
 {
     //-- Error checking.
 
@@ -26,6 +26,7 @@
 #define HILBERT_TRANSFORM_H
 
 #include <memory>
+#include <span>
 
 #include "pocketfft.h"
 
@@ -64,6 +65,11 @@ public:
 	** =========================================================================== */
 	void process(const std::vector<double> &source, std::vector<double> &target);
 
+	/* ===========================================================================
+	**  Process a contiguous window, e.g. from a MirroredRingBuffer.
+	** =========================================================================== */
+	void process(std::span<const double> source, std::vector<double> &target);
+
 	/* ===========================================================================
 	**  Resize.
 	** =========================================================================== */
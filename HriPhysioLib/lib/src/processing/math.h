@@ -26,6 +26,7 @@
 #define HRI_PHYSIO_PROCESSING_MATH_H
 
 #include "../utilities/helpers.h"
+#include "../core/ring_span.h"
 #include <numbers> // Requires C++20
 #include <cmath>
 
@@ -56,6 +57,29 @@ T mean(const std::vector<T> &vec)
     return ret;
 }
 
+template <typename T>
+T mean(const RingSpan<T> &view)
+{
+    T ret = T();
+    if (view.empty())
+    {
+        return ret;
+    }
+
+    for (const T &value : view.first)
+    {
+        ret += value;
+    }
+    for (const T &value : view.second)
+    {
+        ret += value;
+    }
+
+    ret /= static_cast<T>(view.size());
+
+    return ret;
+}
+
 template <typename T>
 T stddev(const std::vector<T> &vec)
 {
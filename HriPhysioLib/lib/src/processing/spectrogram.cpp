@@ -81,6 +81,12 @@ double Spectrogram::absoluteSquare(const std::complex<double> value)
 
 auto Spectrogram::process(const std::vector<double> &source, std::vector<std::vector<double>> &target,
                           const double sample_rate, const double stride_ms, const double window_ms) -> void
+{
+    process(std::span<const double>(source), target, sample_rate, stride_ms, window_ms);
+}
+
+auto Spectrogram::process(std::span<const double> source, std::vector<std::vector<double>> &target,
+                          const double sample_rate, const double stride_ms, const double window_ms) -> void
 {
     const auto stride_size = static_cast<std::size_t>(0.001 * sample_rate * stride_ms);
     const auto window_size = static_cast<std::size_t>(0.001 * sample_rate * window_ms);
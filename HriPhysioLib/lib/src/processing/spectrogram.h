@@ -25,6 +25,8 @@
 #ifndef SPECTROGRAM_H
 #define SPECTROGRAM_H
 
+#include <span>
+
 #include "pocketfft.h"
 
 /**
@@ -92,6 +94,17 @@ public:
 	void process(const std::vector<double> &source, std::vector<std::vector<double>> &target, double sample_rate,
 				 double stride_ms = 20.0, double window_ms = 20.0);
 
+	/**
+	 * Processes a contiguous window of samples, e.g. from a MirroredRingBuffer.
+	 * @param source Input data.
+	 * @param target Output spectrogram.
+	 * @param sample_rate Sample rate of the input data.
+	 * @param stride_ms Stride in milliseconds.
+	 * @param window_ms Window size in milliseconds.
+	 */
+	void process(std::span<const double> source, std::vector<std::vector<double>> &target, double sample_rate,
+				 double stride_ms = 20.0, double window_ms = 20.0);
+
 	/**
 	 * Resizes the internal buffers.
 	 * @param samples New number of samples.
@@ -0,0 +1,401 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Shrikar Nakhye,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Shrikar Nakhye <shrikar.nakhye@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+#include "bin_streamer.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+
+namespace
+{
+    constexpr char header_magic[8] = {'H', 'R', 'I', 'P', 'B', 'I', 'N', 1};
+    constexpr char index_magic[8] = {'H', 'R', 'I', 'P', 'I', 'D', 'X', 1};
+
+    //-- Magic, tag, reserved, channels, rate and name length.
+    constexpr std::size_t fixed_header_size = 8 + 1 + 3 + 4 + 8 + 4;
+
+    //-- Frame count and flags, after the length prefix.
+    constexpr std::size_t block_header_size = 4 + 4;
+
+    //-- Entry count, index offset and magic at the very end.
+    constexpr std::size_t index_trailer_size = 8 + 8 + 8;
+
+    constexpr std::uint32_t has_timestamps = 1;
+
+    //-- Offset, first frame and first timestamp of an index entry on disk.
+    constexpr std::size_t index_entry_size = 8 + 8 + 8;
+    static_assert(sizeof(BinStreamer::IndexEntry) == index_entry_size, "IndexEntry must match its on-disk layout");
+
+    //-- Fields in the mapping are not aligned, so read them by copy.
+    template <typename T>
+    T load(const char *bytes)
+    {
+        T value;
+        std::memcpy(&value, bytes, sizeof(T));
+        return value;
+    }
+}
+
+BinStreamer::BinStreamer() : StreamerInterface(),
+                             write_index(true),
+                             index_spacing(256),
+                             write_offset(0),
+                             frames_written(0),
+                             last_indexed_frame(0),
+                             input_index(nullptr),
+                             input_index_size(0),
+                             first_block(0),
+                             block_offset(0),
+                             block_frame(0) {}
+
+BinStreamer::~BinStreamer()
+{
+    if (this->mode == ModeTag::SENDER)
+    {
+        const std::uint32_t end_marker = 0;
+        this->write_bytes(&end_marker, sizeof(end_marker));
+
+        if (write_index)
+        {
+            const std::uint64_t index_offset = write_offset;
+            for (const IndexEntry &entry : index)
+            {
+                this->write_bytes(&entry.offset, sizeof(entry.offset));
+                this->write_bytes(&entry.first_frame, sizeof(entry.first_frame));
+                this->write_bytes(&entry.first_timestamp, sizeof(entry.first_timestamp));
+            }
+
+            const std::uint64_t num_entries = index.size();
+            this->write_bytes(&num_entries, sizeof(num_entries));
+            this->write_bytes(&index_offset, sizeof(index_offset));
+            this->write_bytes(index_magic, sizeof(index_magic));
+        }
+
+        output.close();
+    }
+    else if (this->mode == ModeTag::RECEIVER)
+    {
+        input.close();
+    }
+}
+
+bool BinStreamer::open_input_stream()
+{
+    if (this->mode != ModeTag::NOT_SET || !input.open(this->name))
+    {
+        return false;
+    }
+
+    const char *data = input.data();
+    const std::size_t size = input.size();
+    if (size < fixed_header_size || std::memcmp(data, header_magic, sizeof(header_magic)) != 0)
+    {
+        std::cerr << "[WARNING] " << this->name << " is not a BIN recording.\n";
+        input.close();
+        return false;
+    }
+
+    const auto tag = static_cast<VarTag>(load<std::uint8_t>(data + 8));
+    const auto channels = load<std::uint32_t>(data + 12);
+    const auto rate = load<double>(data + 16);
+    const auto name_length = load<std::uint32_t>(data + 24);
+    if (fixed_header_size + name_length > size)
+    {
+        std::cerr << "[WARNING] Header of " << this->name << " is truncated.\n";
+        input.close();
+        return false;
+    }
+
+    this->set_var_tag(tag);
+    this->num_channels = channels;
+    this->sampling_rate = static_cast<std::size_t>(rate);
+    this->stream_name.assign(data + fixed_header_size, name_length);
+    if (!this->check_format() || this->element_size() == 0)
+    {
+        input.close();
+        return false;
+    }
+
+    first_block = fixed_header_size + name_length;
+    block_offset = first_block;
+    block_frame = 0;
+
+    //-- Use the index footer only if it is complete and consistent.
+    input_index = nullptr;
+    input_index_size = 0;
+    if (size >= first_block + index_trailer_size &&
+        std::memcmp(data + size - sizeof(index_magic), index_magic, sizeof(index_magic)) == 0)
+    {
+        const auto num_entries = load<std::uint64_t>(data + size - index_trailer_size);
+        const auto index_offset = load<std::uint64_t>(data + size - index_trailer_size + 8);
+        if (index_offset >= first_block &&
+            index_offset + num_entries * index_entry_size + index_trailer_size == size)
+        {
+            input_index = data + index_offset;
+            input_index_size = num_entries;
+        }
+    }
+
+    this->set_mode(ModeTag::RECEIVER);
+    return true;
+}
+
+bool BinStreamer::open_output_stream()
+{
+    if (this->mode != ModeTag::NOT_SET || !this->check_format())
+    {
+        return false;
+    }
+
+    if (this->element_size() == 0)
+    {
+        std::cerr << "[WARNING] BIN recordings hold numeric samples, not " << this->dtype << ".\n";
+        return false;
+    }
+
+    output.open(this->name, std::ios::binary | std::ios::trunc);
+    if (!output)
+    {
+        std::cerr << "[WARNING] Could not create " << this->name << ".\n";
+        return false;
+    }
+
+    if (stream_name.empty())
+    {
+        stream_name = std::filesystem::path(this->name).stem().string();
+    }
+
+    const auto tag = static_cast<std::uint8_t>(this->var);
+    const std::uint8_t reserved[3] = {0, 0, 0};
+    const auto channels = static_cast<std::uint32_t>(this->num_channels);
+    const auto rate = static_cast<double>(this->sampling_rate);
+    const auto name_length = static_cast<std::uint32_t>(stream_name.size());
+
+    this->write_bytes(header_magic, sizeof(header_magic));
+    this->write_bytes(&tag, sizeof(tag));
+    this->write_bytes(reserved, sizeof(reserved));
+    this->write_bytes(&channels, sizeof(channels));
+    this->write_bytes(&rate, sizeof(rate));
+    this->write_bytes(&name_length, sizeof(name_length));
+    this->write_bytes(stream_name.data(), stream_name.size());
+
+    this->set_mode(ModeTag::SENDER);
+    return true;
+}
+
+void BinStreamer::set_stream_name(std::string new_stream_name)
+{
+    this->stream_name = std::move(new_stream_name);
+}
+
+const std::string &BinStreamer::get_stream_name() const
+{
+    return this->stream_name;
+}
+
+void BinStreamer::set_index(bool enabled, std::size_t spacing)
+{
+    this->write_index = enabled;
+    this->index_spacing = spacing;
+}
+
+void BinStreamer::flush()
+{
+    output.flush();
+}
+
+bool BinStreamer::publish_buffer(const void *buffer, std::size_t num_elements, std::span<const double> timestamps)
+{
+    std::size_t num_frames = num_elements / this->num_channels;
+    if (!timestamps.empty())
+    {
+        num_frames = std::min(num_frames, timestamps.size());
+    }
+
+    const std::size_t frame_bytes = this->num_channels * this->element_size();
+    const std::size_t stamp_bytes = timestamps.empty() ? 0 : sizeof(double);
+    const std::uint32_t flags = timestamps.empty() ? 0 : has_timestamps;
+
+    //-- The length prefix is 32 bits, so very large buffers become several blocks.
+    const std::size_t max_frames = (std::numeric_limits<std::uint32_t>::max() - block_header_size) /
+                                   (frame_bytes + stamp_bytes);
+
+    const char *samples = static_cast<const char *>(buffer);
+    std::size_t done = 0;
+    while (done < num_frames)
+    {
+        const std::size_t frames = std::min(num_frames - done, max_frames);
+
+        if (write_index && (index.empty() || frames_written - last_indexed_frame >= index_spacing))
+        {
+            index.push_back({write_offset, frames_written, timestamps.empty() ? 0.0 : timestamps[done]});
+            last_indexed_frame = frames_written;
+        }
+
+        const auto block_bytes = static_cast<std::uint32_t>(block_header_size + frames * (stamp_bytes + frame_bytes));
+        const auto block_frames = static_cast<std::uint32_t>(frames);
+        this->write_bytes(&block_bytes, sizeof(block_bytes));
+        this->write_bytes(&block_frames, sizeof(block_frames));
+        this->write_bytes(&flags, sizeof(flags));
+        if (!timestamps.empty())
+        {
+            this->write_bytes(timestamps.data() + done, frames * sizeof(double));
+        }
+        this->write_bytes(samples + done * frame_bytes, frames * frame_bytes);
+
+        frames_written += frames;
+        done += frames;
+    }
+
+    return static_cast<bool>(output);
+}
+
+std::size_t BinStreamer::receive_buffer(void *buffer, std::size_t num_elements, std::span<double> timestamps)
+{
+    std::size_t num_frames = num_elements / this->num_channels;
+    if (!timestamps.empty())
+    {
+        num_frames = std::min(num_frames, timestamps.size());
+    }
+
+    //-- The element type was matched against the header by receive(), so a plain copy is exact.
+    const std::size_t frame_bytes = this->num_channels * this->element_size();
+    char *destination = static_cast<char *>(buffer);
+    std::size_t frames = 0;
+
+    Block block{};
+    while (frames < num_frames && this->read_block(block_offset, block))
+    {
+        if (block_frame >= block.num_frames)
+        {
+            block_offset = block.next;
+            block_frame = 0;
+            continue;
+        }
+
+        const std::size_t count = std::min(block.num_frames - block_frame, num_frames - frames);
+        std::memcpy(destination + frames * frame_bytes, block.samples + block_frame * frame_bytes, count * frame_bytes);
+
+        if (!timestamps.empty())
+        {
+            if (block.timestamps != nullptr)
+            {
+                std::memcpy(timestamps.data() + frames, block.timestamps + block_frame * sizeof(double),
+                            count * sizeof(double));
+            }
+            else
+            {
+                std::fill_n(timestamps.data() + frames, count, 0.0);
+            }
+        }
+
+        block_frame += count;
+        frames += count;
+    }
+
+    return frames * this->num_channels;
+}
+
+bool BinStreamer::seek(double timestamp)
+{
+    if (this->mode != ModeTag::RECEIVER)
+    {
+        return false;
+    }
+
+    //-- Start from the last indexed block that begins before the timestamp; an earlier block
+    //-- may still end in frames stamped exactly at it.
+    std::size_t offset = first_block;
+    if (input_index != nullptr)
+    {
+        std::size_t low = 0;
+        std::size_t high = input_index_size;
+        while (low < high)
+        {
+            const std::size_t mid = (low + high) / 2;
+            const char *entry = input_index + mid * index_entry_size;
+            if (load<double>(entry + 16) < timestamp)
+            {
+                low = mid + 1;
+            }
+            else
+            {
+                high = mid;
+            }
+        }
+        if (low > 0)
+        {
+            offset = load<std::uint64_t>(input_index + (low - 1) * index_entry_size);
+        }
+    }
+
+    //-- Frames recorded without timestamps count as timestamp 0.
+    Block block{};
+    while (this->read_block(offset, block))
+    {
+        for (std::size_t frame = 0; frame < block.num_frames; ++frame)
+        {
+            const double stamp = (block.timestamps != nullptr)
+                                     ? load<double>(block.timestamps + frame * sizeof(double))
+                                     : 0.0;
+            if (stamp >= timestamp)
+            {
+                block_offset = offset;
+                block_frame = frame;
+                return true;
+            }
+        }
+        offset = block.next;
+    }
+
+    return false;
+}
+
+bool BinStreamer::read_block(std::size_t offset, Block &block) const
+{
+    const char *data = input.data();
+    const std::size_t size = input.size();
+    if (offset + sizeof(std::uint32_t) + block_header_size > size)
+    {
+        return false;
+    }
+
+    //-- A zero length marks the end; a block running past the file was cut short by a crash.
+    const auto block_bytes = load<std::uint32_t>(data + offset);
+    if (block_bytes < block_header_size || offset + sizeof(std::uint32_t) + block_bytes > size)
+    {
+        return false;
+    }
+
+    const char *start = data + offset + sizeof(std::uint32_t);
+    block.num_frames = load<std::uint32_t>(start);
+    const auto flags = load<std::uint32_t>(start + 4);
+
+    const std::size_t stamp_bytes = (flags & has_timestamps) ? block.num_frames * sizeof(double) : 0;
+    const std::size_t sample_bytes = block.num_frames * this->num_channels * this->element_size();
+    if (block_header_size + stamp_bytes + sample_bytes != block_bytes)
+    {
+        std::cerr << "[WARNING] Corrupt block at offset " << offset << " of " << this->name << ".\n";
+        return false;
+    }
+
+    block.timestamps = (flags & has_timestamps) ? start + block_header_size : nullptr;
+    block.samples = start + block_header_size + stamp_bytes;
+    block.next = offset + sizeof(std::uint32_t) + block_bytes;
+    return true;
+}
+
+void BinStreamer::write_bytes(const void *bytes, std::size_t size)
+{
+    output.write(static_cast<const char *>(bytes), static_cast<std::streamsize>(size));
+    write_offset += size;
+}
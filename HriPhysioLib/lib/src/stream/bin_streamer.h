@@ -0,0 +1,211 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Shrikar Nakhye,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Shrikar Nakhye <shrikar.nakhye@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+#ifndef HRI_PHYSIO_BIN_STREAMER_H
+#define HRI_PHYSIO_BIN_STREAMER_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+#include "streamer_interface.h"
+
+/**
+ * @class BinStreamer
+ * @brief Records samples to, and replays them from, a chunked binary file.
+ *
+ * All fields are in host byte order (little-endian on every supported target):
+ *
+ *     header  "HRIPBIN" + version byte, uint8 VarTag, 3 reserved bytes,
+ *             uint32 channels, double nominal rate, uint32 name length, name
+ *     block   uint32 bytes that follow, uint32 frames, uint32 flags (bit 0:
+ *             timestamps present), double timestamps[frames] if present,
+ *             samples[frames * channels] interleaved
+ *     end     uint32 0
+ *     index   { uint64 block offset, uint64 first frame, double first
+ *             timestamp } per indexed block, uint64 entries, uint64 index
+ *             offset, "HRIPIDX" + version byte
+ *
+ * Every publish() becomes one block. The end marker and index are written
+ * on destruction; a file cut short by a crash still reads up to its last
+ * complete block, it just cannot seek quickly.
+ */
+class BinStreamer : public StreamerInterface
+{
+public:
+    /**
+     * @struct IndexEntry
+     * @brief Where a block starts in the file and in the stream.
+     */
+    struct IndexEntry
+    {
+        std::uint64_t offset;
+        std::uint64_t first_frame;
+        double first_timestamp;
+    };
+
+private:
+    /**
+     * Output file stream for writing blocks.
+     */
+    std::ofstream output;
+
+    /**
+     * Input file, mapped read-only.
+     */
+    MappedFile input;
+
+    /**
+     * Stream name stored in the header.
+     */
+    std::string stream_name;
+
+    /**
+     * Flag to indicate if the index footer is written on close.
+     */
+    bool write_index;
+
+    /**
+     * Minimum number of frames between indexed blocks.
+     */
+    std::size_t index_spacing;
+
+    /**
+     * Blocks indexed so far while writing.
+     */
+    std::vector<IndexEntry> index;
+
+    /**
+     * Bytes written so far, frames written so far, and the first frame of the last indexed block.
+     */
+    std::uint64_t write_offset;
+    std::uint64_t frames_written;
+    std::uint64_t last_indexed_frame;
+
+    /**
+     * Index footer of the input file, nullptr if it has none.
+     */
+    const char *input_index;
+    std::size_t input_index_size;
+
+    /**
+     * Offset of the first block, of the block being read, and frames of it already read.
+     */
+    std::size_t first_block;
+    std::size_t block_offset;
+    std::size_t block_frame;
+
+public:
+    /**
+     * Constructor to initialize the BinStreamer.
+     */
+    BinStreamer();
+
+    /**
+     * Destructor writes the end marker and index, and closes the file.
+     */
+    ~BinStreamer();
+
+    /**
+     * Opens a recording for reading. The data type, channel count, rate and
+     * stream name are taken from the file's header.
+     * @return True if the file has a valid header, false otherwise.
+     */
+    bool open_input_stream() override;
+
+    /**
+     * Creates a recording and writes its header.
+     * @return True if the file is created, false otherwise.
+     */
+    bool open_output_stream() override;
+
+    /**
+     * Sets the stream name stored in the header, the file's stem by default.
+     * @param new_stream_name Name of the recorded stream.
+     */
+    void set_stream_name(std::string new_stream_name);
+
+    /**
+     * Gets the stream name from the header of the recording.
+     * @return Name of the recorded stream.
+     */
+    [[nodiscard]] const std::string &get_stream_name() const;
+
+    /**
+     * Chooses whether an index footer is written, and how dense it is.
+     * @param enabled True to write the index (the default).
+     * @param spacing Minimum number of frames between indexed blocks.
+     */
+    void set_index(bool enabled, std::size_t spacing = 256);
+
+    /**
+     * Positions the reader on the first frame at or after a timestamp, using
+     * the index footer when the file has one and scanning the blocks otherwise.
+     * @param timestamp Timestamp to seek to.
+     * @return True if such a frame exists, false otherwise.
+     */
+    bool seek(double timestamp);
+
+    /**
+     * Writes all buffered blocks to the file.
+     */
+    void flush();
+
+protected:
+    /**
+     * Writes the samples as one block.
+     * @param buffer Elements of the stream's data type.
+     * @param num_elements Number of elements in the buffer.
+     * @param timestamps One timestamp per frame, or empty.
+     * @return True if the block was written, false otherwise.
+     */
+    bool publish_buffer(const void *buffer, std::size_t num_elements, std::span<const double> timestamps) override;
+
+    /**
+     * Copies frames out of the mapped blocks, continuing mid-block where the last call stopped.
+     * @param buffer Destination for elements of the stream's data type.
+     * @param num_elements Capacity of the destination in elements.
+     * @param timestamps Destination for one timestamp per frame, or empty; 0 if not recorded.
+     * @return Number of elements written, 0 at the end of the recording.
+     */
+    std::size_t receive_buffer(void *buffer, std::size_t num_elements, std::span<double> timestamps) override;
+
+private:
+    /**
+     * @struct Block
+     * @brief A block of the input file, as located in the mapping.
+     */
+    struct Block
+    {
+        std::size_t num_frames;
+        const char *timestamps;
+        const char *samples;
+        std::size_t next;
+    };
+
+    /**
+     * Locates the block at an offset of the input file.
+     * @param offset Offset of the block's length prefix.
+     * @param block Destination for the block.
+     * @return True if a complete block starts there, false at the end.
+     */
+    bool read_block(std::size_t offset, Block &block) const;
+
+    /**
+     * Appends raw bytes to the output file.
+     * @param bytes Bytes to write.
+     * @param size Number of bytes.
+     */
+    void write_bytes(const void *bytes, std::size_t size);
+};
+
+#endif // HRI_PHYSIO_BIN_STREAMER_H
@@ -22,43 +22,99 @@
  * ================================================================================
  */
 #include "csv_streamer.h"
-#include "csv_streamer.h"
-#include <iomanip>     // For std::setprecision, std::put_time
-#include <ctime>       // For std::time, std::localtime
+#include <algorithm>   // For std::max, std::copy_n
+#include <charconv>    // For std::to_chars
+#include <ctime>       // For std::time, localtime_r
 #include <fstream>     // For file stream operations
 #include <iostream>    // For std::cerr
+#include <limits>      // For std::numeric_limits
 #include <vector>      // For std::vector
 #include <string>      // For std::string
+#include <cstring>     // For std::memchr
+
+namespace {
+    //-- Enough for any int64 or the shortest round-trip form of any double.
+    constexpr std::size_t max_number_chars = 32;
+
+    //-- Smallest write buffer, so one publish call usually becomes one write.
+    constexpr std::size_t min_write_buffer = 64 * 1024;
+
+    template<typename T>
+    char *format_number(char *out, T value) {
+        //-- Promote 8-bit samples so they are written as numbers, not characters.
+        if constexpr (sizeof(T) == 1) {
+            return std::to_chars(out, out + max_number_chars, static_cast<int>(value)).ptr;
+        } else {
+            return std::to_chars(out, out + max_number_chars, value).ptr;
+        }
+    }
+
+    char *format_timestamp(char *out, double timestamp) {
+        //-- Same 10 significant digits the iostream writer used.
+        return std::to_chars(out, out + max_number_chars, timestamp, std::chars_format::general, 10).ptr;
+    }
+
+    template<typename T>
+    bool parse_number(const char *first, const char *last, T &value) {
+        while (first != last && (*first == ' ' || *first == '+')) {
+            ++first;
+        }
+        while (last != first && (last[-1] == ' ' || last[-1] == '\r')) {
+            --last;
+        }
 
+        //-- Parse 8-bit samples as numbers, not characters.
+        if constexpr (sizeof(T) == 1) {
+            int wide = 0;
+            auto result = std::from_chars(first, last, wide);
+            if (result.ec != std::errc() || result.ptr != last || first == last ||
+                wide < std::numeric_limits<T>::min() || wide > std::numeric_limits<T>::max()) {
+                return false;
+            }
+            value = static_cast<T>(wide);
+            return true;
+        } else {
+            auto result = std::from_chars(first, last, value);
+            return result.ec == std::errc() && result.ptr == last && first != last;
+        }
+    }
+}
 
-CSVStreamer::CSVStreamer() : StreamerInterface() {}
+CSVStreamer::CSVStreamer() : StreamerInterface(),
+                             write_buffer(min_write_buffer),
+                             write_used(0),
+                             flush_size(0),
+                             flush_interval(std::chrono::seconds(1)),
+                             last_flush(std::chrono::steady_clock::now()),
+                             prefix_second(-1),
+                             prefix{},
+                             prefix_length(0),
+                             input_offset(0) {}
 
 CSVStreamer::~CSVStreamer() {
     if (this->mode == ModeTag::RECEIVER) {
         input.close();
     } else if (this->mode == ModeTag::SENDER) {
+        this->flush();
         output.close();
     }
 }
 
 bool CSVStreamer::open_input_stream() {
-    if (this->mode != ModeTag::NOT_SET) {
+    if (this->mode != ModeTag::NOT_SET || !this->check_format()) {
         return false;
     }
 
-    this->set_mode(ModeTag::RECEIVER);
-
-    try {
-        input.open(this->name);
-        return true;
-    } catch (std::exception &e) {
-        std::cerr << "Exception: " << e.what() << std::endl;
+    if (!input.open(this->name)) {
         return false;
     }
+
+    this->set_mode(ModeTag::RECEIVER);
+    return true;
 }
 
 bool CSVStreamer::open_output_stream() {
-    if (this->mode != ModeTag::NOT_SET) {
+    if (this->mode != ModeTag::NOT_SET || !this->check_format()) {
         return false;
     }
 
@@ -73,67 +129,221 @@ bool CSVStreamer::open_output_stream() {
     }
 }
 
-void CSVStreamer::publish(const std::vector<VarTag> &buffer, const std::vector<double> *timestamps) {
+bool CSVStreamer::publish_buffer(const void *buffer, std::size_t num_elements, std::span<const double> timestamps) {
+    //-- The element type was matched against var by publish(), so these casts are exact.
+    switch (this->var) {
+        case VarTag::CHAR:
+            this->push_stream(static_cast<const char *>(buffer), num_elements, timestamps);
+            return true;
+        case VarTag::INT16:
+            this->push_stream(static_cast<const int16_t *>(buffer), num_elements, timestamps);
+            return true;
+        case VarTag::INT32:
+            this->push_stream(static_cast<const int32_t *>(buffer), num_elements, timestamps);
+            return true;
+        case VarTag::INT64:
+            this->push_stream(static_cast<const int64_t *>(buffer), num_elements, timestamps);
+            return true;
+        case VarTag::FLOAT:
+            this->push_stream(static_cast<const float *>(buffer), num_elements, timestamps);
+            return true;
+        case VarTag::DOUBLE:
+            this->push_stream(static_cast<const double *>(buffer), num_elements, timestamps);
+            return true;
+        default:
+            return false;
+    }
+}
+
+std::size_t CSVStreamer::receive_buffer(void *buffer, std::size_t num_elements, std::span<double> timestamps) {
+    std::size_t num_frames = num_elements / this->num_channels;
+    if (!timestamps.empty()) {
+        num_frames = std::min(num_frames, timestamps.size());
+    }
+
     switch (this->var) {
         case VarTag::CHAR:
-            this->push_stream<char>(reinterpret_cast<const std::vector<char> &>(buffer), timestamps);
-            break;
+            return this->pull_stream(static_cast<char *>(buffer), num_frames, timestamps) * this->num_channels;
         case VarTag::INT16:
-            this->push_stream<int16_t>(reinterpret_cast<const std::vector<int16_t> &>(buffer), timestamps);
-            break;
+            return this->pull_stream(static_cast<int16_t *>(buffer), num_frames, timestamps) * this->num_channels;
         case VarTag::INT32:
-            this->push_stream<int32_t>(reinterpret_cast<const std::vector<int32_t> &>(buffer), timestamps);
-            break;
+            return this->pull_stream(static_cast<int32_t *>(buffer), num_frames, timestamps) * this->num_channels;
         case VarTag::INT64:
-            this->push_stream<int64_t>(reinterpret_cast<const std::vector<int64_t> &>(buffer), timestamps);
-            break;
+            return this->pull_stream(static_cast<int64_t *>(buffer), num_frames, timestamps) * this->num_channels;
         case VarTag::FLOAT:
-            this->push_stream<float>(reinterpret_cast<const std::vector<float> &>(buffer), timestamps);
-            break;
+            return this->pull_stream(static_cast<float *>(buffer), num_frames, timestamps) * this->num_channels;
         case VarTag::DOUBLE:
-            this->push_stream<double>(reinterpret_cast<const std::vector<double> &>(buffer), timestamps);
-            break;
+            return this->pull_stream(static_cast<double *>(buffer), num_frames, timestamps) * this->num_channels;
         default:
-            break;
+            return 0;
     }
 }
 
+void CSVStreamer::set_write_buffer(std::size_t size, double interval) {
+    this->flush_size = size;
+    this->flush_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(interval));
+
+    if (write_buffer.size() < size) {
+        write_buffer.resize(size);
+    }
+}
+
+void CSVStreamer::set_input_column(std::size_t column) {
+    this->input_column = column;
+}
+
+void CSVStreamer::flush() {
+    if (write_used != 0) {
+        output.write(write_buffer.data(), static_cast<std::streamsize>(write_used));
+        write_used = 0;
+    }
+    output.flush();
+    last_flush = std::chrono::steady_clock::now();
+}
+
 void CSVStreamer::publish(const std::string &buffer, const double *timestamps) {
-    std::time_t time = std::time(nullptr);
-    output << std::put_time(std::localtime(&time), "%Y/%m/%d_%H:%M:%S") << ",";
+    this->update_prefix();
+
+    char *out = this->reserve_row(prefix_length + max_number_chars + buffer.size() + 5);
+    out = std::copy_n(prefix.data(), prefix_length, out);
+    *out++ = ',';
+    out = format_timestamp(out, timestamps == nullptr ? 0.0 : *timestamps);
+    *out++ = ',';
+    *out++ = '"';
+    out = std::copy_n(buffer.data(), buffer.size(), out);
+    *out++ = '"';
+    *out++ = '\n';
+    write_used = out - write_buffer.data();
+
+    this->finish_publish();
+}
+
+void CSVStreamer::update_prefix() {
+    const std::time_t now = std::time(nullptr);
+    if (now == prefix_second) {
+        return;
+    }
+
+    std::tm local{};
+    localtime_r(&now, &local);
+    prefix_length = std::strftime(prefix.data(), prefix.size(), "%Y/%m/%d_%H:%M:%S", &local);
+    prefix_second = now;
+}
 
-    if (timestamps == nullptr) {
-        output << 0.0;
-    } else {
-        output << std::setprecision(10) << (*timestamps);
+char *CSVStreamer::reserve_row(std::size_t row_size) {
+    if (write_used + row_size > write_buffer.size()) {
+        output.write(write_buffer.data(), static_cast<std::streamsize>(write_used));
+        write_used = 0;
+
+        if (row_size > write_buffer.size()) {
+            write_buffer.resize(row_size);
+        }
     }
+    return write_buffer.data() + write_used;
+}
 
-    output << "," << "\"" << buffer << "\"";
-    output << std::endl;
+void CSVStreamer::finish_publish() {
+    if (flush_size == 0 || write_used >= flush_size ||
+        std::chrono::steady_clock::now() - last_flush >= flush_interval) {
+        this->flush();
+    }
 }
 
 template<typename T>
-void CSVStreamer::push_stream(const std::vector<T> &buffer, const std::vector<double> *timestamps) {
-    std::time_t time = std::time(nullptr);
+void CSVStreamer::push_stream(const T *buffer, std::size_t num_elements, std::span<const double> timestamps) {
+    this->update_prefix();
+
+    const std::size_t row_size = prefix_length + (this->num_channels + 1) * (max_number_chars + 1) + 1;
 
     std::size_t idx_buffer = 0;
     std::size_t idx_time = 0;
 
-    while (idx_buffer < buffer.size()) {
-        output << std::put_time(std::localtime(&time), "%Y/%m/%d_%H:%M:%S") << ",";
+    while (idx_buffer + this->num_channels <= num_elements) {
+        char *out = this->reserve_row(row_size);
+        out = std::copy_n(prefix.data(), prefix_length, out);
+        *out++ = ',';
 
-        if (timestamps == nullptr || timestamps->empty()) {
-            output << 0.0;
+        if (idx_time >= timestamps.size()) {
+            *out++ = '0';
         } else {
-            output << std::setprecision(10) << timestamps->at(idx_time);
+            out = format_timestamp(out, timestamps[idx_time]);
             ++idx_time;
         }
 
         for (std::size_t ch = 0; ch < this->num_channels; ++ch) {
-            output << "," << buffer[idx_buffer + ch];
+            *out++ = ',';
+            out = format_number(out, buffer[idx_buffer + ch]);
         }
         idx_buffer += this->num_channels;
 
-        output << std::endl;
+        *out++ = '\n';
+        write_used = out - write_buffer.data();
     }
-}
\ No newline at end of file
+
+    this->finish_publish();
+}
+
+template<typename T>
+std::size_t CSVStreamer::pull_stream(T *buffer, std::size_t num_frames, std::span<double> timestamps) {
+    const char *begin = input.data();
+    const char *end = begin + input.size();
+    std::size_t frames = 0;
+
+    while (frames < num_frames && input_offset < input.size()) {
+        const char *line = begin + input_offset;
+        const char *line_end = static_cast<const char *>(std::memchr(line, '\n', end - line));
+        if (line_end == nullptr) {
+            line_end = end;
+        }
+        const bool first_row = (input_offset == 0);
+        input_offset = (line_end - begin) + 1;
+
+        //-- Split the row on commas; the field list is reused, so this only allocates on the first rows.
+        fields.clear();
+        fields.push_back(line);
+        for (const char *c = line; c != line_end; ++c) {
+            if (*c == ',') {
+                fields.push_back(c + 1);
+            }
+        }
+        if (line == line_end || (line_end - line == 1 && *line == '\r')) {
+            continue;
+        }
+        const std::size_t min_fields = input_column.value_or(0) + this->num_channels;
+        if (fields.size() < min_fields) {
+            std::cerr << "[WARNING] Skipping row of " << this->name << " with " << fields.size()
+                      << " fields, expected at least " << min_fields << ".\n";
+            continue;
+        }
+        fields.push_back(line_end + 1);
+
+        //-- Samples are the last num_channels fields, the timestamp the one before them,
+        //-- unless the caller picked the column.
+        const std::size_t first_channel = input_column.value_or(fields.size() - 1 - this->num_channels);
+        T *frame = buffer + frames * this->num_channels;
+        bool parsed = true;
+        for (std::size_t ch = 0; ch < this->num_channels && parsed; ++ch) {
+            parsed = parse_number(fields[first_channel + ch], fields[first_channel + ch + 1] - 1, frame[ch]);
+        }
+
+        double timestamp = 0.0;
+        if (parsed && first_channel > 0 && !input_column) {
+            parsed = parse_number(fields[first_channel - 1], fields[first_channel] - 1, timestamp);
+        }
+
+        if (!parsed) {
+            if (!first_row) {
+                std::cerr << "[WARNING] Skipping unparsable row of " << this->name << ".\n";
+            }
+            continue;
+        }
+
+        if (!timestamps.empty()) {
+            timestamps[frames] = timestamp;
+        }
+        ++frames;
+    }
+
+    return frames;
+}
@@ -24,9 +24,14 @@
 #ifndef HRI_PHYSIO_CSV_STREAMER_H
 #define HRI_PHYSIO_CSV_STREAMER_H
 
+#include <array>
+#include <chrono>
+#include <ctime>
 #include <iostream>
 #include <fstream>
+#include <optional>
 #include <vector>
+#include "mapped_file.h"
 #include "streamer_interface.h"
 
 /**
@@ -42,9 +47,60 @@ private:
     std::ofstream output;
 
     /**
-     * System time for timestamping data.
+     * Rows formatted but not yet handed to the file.
      */
-    std::string system_time;
+    std::vector<char> write_buffer;
+
+    /**
+     * Number of bytes used in the write buffer.
+     */
+    std::size_t write_used;
+
+    /**
+     * Buffered bytes that trigger a flush, 0 to flush after every publish.
+     */
+    std::size_t flush_size;
+
+    /**
+     * Longest time rows may stay buffered before a publish flushes them.
+     */
+    std::chrono::steady_clock::duration flush_interval;
+
+    /**
+     * Time of the last flush.
+     */
+    std::chrono::steady_clock::time_point last_flush;
+
+    /**
+     * Second for which the wall-clock prefix was formatted.
+     */
+    std::time_t prefix_second;
+
+    /**
+     * Wall-clock prefix "YYYY/MM/DD_HH:MM:SS" of every row, and its length.
+     */
+    std::array<char, 32> prefix;
+    std::size_t prefix_length;
+
+    /**
+     * Input file, mapped read-only.
+     */
+    MappedFile input;
+
+    /**
+     * Offset of the next unread row in the input file.
+     */
+    std::size_t input_offset;
+
+    /**
+     * Field holding the first sample of a row, unset to read the last num_channels fields.
+     */
+    std::optional<std::size_t> input_column;
+
+    /**
+     * Start of every field of the row being parsed, reused across rows.
+     */
+    std::vector<const char *> fields;
 
 public:
     /**
@@ -57,29 +113,42 @@ public:
      */
     ~CSVStreamer();
 
-    /**
-     * Input file stream for reading CSV data.
-     */
-    std::ifstream input;
-
     /**
      * Opens the input CSV stream.
      * @return True if the input stream is successfully opened, false otherwise.
      */
-    bool open_input_stream();
+    bool open_input_stream() override;
 
     /**
      * Opens the output CSV stream.
      * @return True if the output stream is successfully opened, false otherwise.
      */
-    bool open_output_stream();
+    bool open_output_stream() override;
 
     /**
-     * Publishes a buffer of data to the CSV stream.
-     * @param buffer Data buffer to be published.
-     * @param timestamps Optional timestamps for the data.
+     * Switches the writer to buffered mode. Rows collect in memory and reach
+     * the file once the buffer holds size bytes or a publish comes more than
+     * flush_interval after the last flush, whichever is first. Rows still
+     * buffered are written by flush() and on destruction.
+     * @param size Bytes to buffer, 0 to flush after every publish (the default).
+     * @param flush_interval Longest time in seconds rows stay buffered.
+     */
+    void set_write_buffer(std::size_t size, double flush_interval = 1.0);
+
+    /**
+     * Writes all buffered rows to the file and flushes it.
+     */
+    void flush();
+
+    /**
+     * Reads the samples from num_channels fields starting at a fixed column
+     * instead of the last fields of the row. Rows then have no timestamp.
+     * @param column Index of the field holding the first sample, from 0.
      */
-    void publish(const std::vector<VarTag> &buffer, const std::vector<double> *timestamps = nullptr);
+    void set_input_column(std::size_t column);
+
+    using StreamerInterface::publish;
+    using StreamerInterface::receive;
 
     /**
      * Publishes a string buffer to the CSV stream.
@@ -88,15 +157,67 @@ public:
      */
     void publish(const std::string &buffer, const double *timestamps = nullptr);
 
+protected:
+    /**
+     * Writes one CSV row per frame of interleaved samples.
+     * @param buffer Elements of the stream's data type.
+     * @param num_elements Number of elements in the buffer.
+     * @param timestamps One timestamp per frame, or empty to write 0.
+     * @return True if the rows were written, false otherwise.
+     */
+    bool publish_buffer(const void *buffer, std::size_t num_elements, std::span<const double> timestamps) override;
+
+    /**
+     * Parses rows of the mapped input file into interleaved samples. The last
+     * num_channels fields of a row are its samples and the field before them,
+     * if any, its timestamp; earlier fields such as the wall-clock prefix are
+     * skipped. set_input_column() picks the sample fields instead. A first
+     * row that does not parse is taken as a header.
+     * @param buffer Destination for elements of the stream's data type.
+     * @param num_elements Capacity of the destination in elements.
+     * @param timestamps Destination for one timestamp per frame, or empty.
+     * @return Number of elements written, 0 at the end of the file.
+     */
+    std::size_t receive_buffer(void *buffer, std::size_t num_elements, std::span<double> timestamps) override;
+
 private:
+    /**
+     * Refreshes the wall-clock prefix when the second has changed.
+     */
+    void update_prefix();
+
+    /**
+     * Makes room for a row in the write buffer, writing it out when full.
+     * @param row_size Largest size the row can have in bytes.
+     * @return Where to format the row.
+     */
+    char *reserve_row(std::size_t row_size);
+
+    /**
+     * Writes out the buffered rows if the flush size or interval was reached.
+     */
+    void finish_publish();
+
     /**
      * Pushes a buffer of data to the stream.
      * @tparam T Type of the data in the buffer.
      * @param buffer Data buffer to be pushed.
-     * @param timestamps Optional timestamps for the data.
+     * @param num_elements Number of elements in the buffer.
+     * @param timestamps One timestamp per frame, or empty.
+     */
+    template <typename T>
+    void push_stream(const T *buffer, std::size_t num_elements, std::span<const double> timestamps);
+
+    /**
+     * Parses rows from the input file into a buffer.
+     * @tparam T Type of the data in the buffer.
+     * @param buffer Buffer to store the parsed data.
+     * @param num_frames Capacity of the buffer in frames.
+     * @param timestamps Destination for one timestamp per frame, or empty.
+     * @return Number of frames written.
      */
     template <typename T>
-    void push_stream(const std::vector<T> &buffer, const std::vector<double> *timestamps);
+    std::size_t pull_stream(T *buffer, std::size_t num_frames, std::span<double> timestamps);
 };
 
 #endif // HRI_PHYSIO_CSV_STREAMER_H
@@ -22,6 +22,7 @@
  * ================================================================================
  */
 #include "lsl_streamer.h"
+#include <algorithm>
 
 LSLStreamer::LSLStreamer() : StreamerInterface() {}
 
@@ -57,7 +58,7 @@ lsl::channel_format_t LSLStreamer::get_lsl_format_type()
 
 bool LSLStreamer::open_input_stream()
 {
-    if (this->mode != ModeTag::NOT_SET)
+    if (this->mode != ModeTag::NOT_SET || !this->check_format())
     {
         return false;
     }
@@ -82,7 +83,7 @@ bool LSLStreamer::open_input_stream()
 
 bool LSLStreamer::open_output_stream()
 {
-    if (this->mode != ModeTag::NOT_SET)
+    if (this->mode != ModeTag::NOT_SET || !this->check_format())
     {
         return false;
     }
@@ -113,59 +114,53 @@ bool LSLStreamer::open_output_stream()
     }
 }
 
-void LSLStreamer::publish(const std::vector<VarTag> &buffer)
+bool LSLStreamer::publish_buffer(const void *buffer, std::size_t num_elements, std::span<const double> timestamps)
 {
+    //-- The element type was matched against var by publish(), so these casts are exact.
     switch (this->var)
     {
     case VarTag::CHAR:
-        this->push_stream<char>(reinterpret_cast<const std::vector<char> &>(buffer));
-        break;
+        this->push_stream(static_cast<const char *>(buffer), num_elements, timestamps);
+        return true;
     case VarTag::INT16:
-        this->push_stream<int16_t>(reinterpret_cast<const std::vector<int16_t> &>(buffer));
-        break;
+        this->push_stream(static_cast<const int16_t *>(buffer), num_elements, timestamps);
+        return true;
     case VarTag::INT32:
-        this->push_stream<int32_t>(reinterpret_cast<const std::vector<int32_t> &>(buffer));
-        break;
+        this->push_stream(static_cast<const int32_t *>(buffer), num_elements, timestamps);
+        return true;
     case VarTag::INT64:
-        this->push_stream<int64_t>(reinterpret_cast<const std::vector<int64_t> &>(buffer));
-        break;
+        this->push_stream(static_cast<const int64_t *>(buffer), num_elements, timestamps);
+        return true;
     case VarTag::FLOAT:
-        this->push_stream<float>(reinterpret_cast<const std::vector<float> &>(buffer));
-        break;
+        this->push_stream(static_cast<const float *>(buffer), num_elements, timestamps);
+        return true;
     case VarTag::DOUBLE:
-        std::cerr << "<double>" << std::endl;
-        this->push_stream<double>(reinterpret_cast<const std::vector<double> &>(buffer));
-        break;
+        this->push_stream(static_cast<const double *>(buffer), num_elements, timestamps);
+        return true;
     default:
         std::cerr << "Unsupported VarTag" << std::endl;
-        break;
+        return false;
     }
 }
 
-void LSLStreamer::receive(std::vector<VarTag> &buffer, std::vector<double> *timestamps)
+std::size_t LSLStreamer::receive_buffer(void *buffer, std::size_t num_elements, std::span<double> timestamps)
 {
     switch (this->var)
     {
     case VarTag::CHAR:
-        this->pull_stream<char>(reinterpret_cast<std::vector<char> &>(buffer), timestamps);
-        break;
+        return this->pull_stream(static_cast<char *>(buffer), num_elements, timestamps);
     case VarTag::INT16:
-        this->pull_stream<int16_t>(reinterpret_cast<std::vector<int16_t> &>(buffer), timestamps);
-        break;
+        return this->pull_stream(static_cast<int16_t *>(buffer), num_elements, timestamps);
     case VarTag::INT32:
-        this->pull_stream<int32_t>(reinterpret_cast<std::vector<int32_t> &>(buffer), timestamps);
-        break;
+        return this->pull_stream(static_cast<int32_t *>(buffer), num_elements, timestamps);
     case VarTag::INT64:
-        this->pull_stream<int64_t>(reinterpret_cast<std::vector<int64_t> &>(buffer), timestamps);
-        break;
+        return this->pull_stream(static_cast<int64_t *>(buffer), num_elements, timestamps);
     case VarTag::FLOAT:
-        this->pull_stream<float>(reinterpret_cast<std::vector<float> &>(buffer), timestamps);
-        break;
+        return this->pull_stream(static_cast<float *>(buffer), num_elements, timestamps);
     case VarTag::DOUBLE:
-        this->pull_stream<double>(reinterpret_cast<std::vector<double> &>(buffer), timestamps);
-        break;
+        return this->pull_stream(static_cast<double *>(buffer), num_elements, timestamps);
     default:
-        break;
+        return 0;
     }
 }
 
@@ -183,13 +178,33 @@ void LSLStreamer::receive(std::string &buffer, double *timestamps)
 }
 
 template <typename T>
-void LSLStreamer::push_stream(const std::vector<T> &buffer)
+void LSLStreamer::push_stream(const T *buffer, std::size_t num_elements, std::span<const double> timestamps)
 {
-    outlet->push_chunk_multiplexed(buffer);
+    //-- Whole frames only; a trailing partial frame would shift every later channel.
+    num_elements -= num_elements % this->num_channels;
+
+    if (timestamps.empty())
+    {
+        outlet->push_chunk_multiplexed(buffer, num_elements);
+    }
+    else
+    {
+        num_elements = std::min(num_elements, timestamps.size() * this->num_channels);
+        outlet->push_chunk_multiplexed(buffer, timestamps.data(), num_elements);
+    }
 }
 
 template <typename T>
-void LSLStreamer::pull_stream(std::vector<T> &buffer, std::vector<double> *timestamps)
+std::size_t LSLStreamer::pull_stream(T *buffer, std::size_t num_elements, std::span<double> timestamps)
 {
-    inlet->pull_chunk_multiplexed(buffer, timestamps, 5.0);
+    num_elements -= num_elements % this->num_channels;
+    if (!timestamps.empty())
+    {
+        num_elements = std::min(num_elements, timestamps.size() * this->num_channels);
+    }
+
+    //-- liblsl wants exactly one timestamp slot per frame of the data buffer.
+    const std::size_t num_timestamps = timestamps.empty() ? 0 : num_elements / this->num_channels;
+    return inlet->pull_chunk_multiplexed(buffer, timestamps.empty() ? nullptr : timestamps.data(),
+                                         num_elements, num_timestamps, 5.0);
 }
@@ -68,26 +68,16 @@ public:
      * Opens the input LSL stream.
      * @return True if the input stream is successfully opened, false otherwise.
      */
-    bool open_input_stream();
+    bool open_input_stream() override;
 
     /**
      * Opens the output LSL stream.
      * @return True if the output stream is successfully opened, false otherwise.
      */
-    bool open_output_stream();
+    bool open_output_stream() override;
 
-    /**
-     * Publishes a buffer of data to the LSL stream.
-     * @param buffer Data buffer to be published.
-     */
-    void publish(const std::vector<VarTag> &buffer);
-
-    /**
-     * Receives data from the LSL stream into a buffer.
-     * @param buffer Buffer to store the received data.
-     * @param timestamps Optional timestamps for the data.
-     */
-    void receive(std::vector<VarTag> &buffer, std::vector<double> *timestamps = nullptr);
+    using StreamerInterface::publish;
+    using StreamerInterface::receive;
 
     /**
      * Publishes a string buffer to the LSL stream.
@@ -102,23 +92,46 @@ public:
      */
     void receive(std::string &buffer, double *timestamps = nullptr);
 
+protected:
+    /**
+     * Pushes interleaved samples to the LSL outlet.
+     * @param buffer Elements of the stream's data type.
+     * @param num_elements Number of elements in the buffer.
+     * @param timestamps One timestamp per frame, or empty to stamp with the current time.
+     * @return True if the samples were pushed, false otherwise.
+     */
+    bool publish_buffer(const void *buffer, std::size_t num_elements, std::span<const double> timestamps) override;
+
+    /**
+     * Pulls interleaved samples from the LSL inlet straight into the destination.
+     * @param buffer Destination for elements of the stream's data type.
+     * @param num_elements Capacity of the destination in elements.
+     * @param timestamps Destination for one timestamp per frame, or empty.
+     * @return Number of elements written.
+     */
+    std::size_t receive_buffer(void *buffer, std::size_t num_elements, std::span<double> timestamps) override;
+
 private:
     /**
      * Pushes a buffer of data to the LSL stream.
      * @tparam T Type of the data in the buffer.
      * @param buffer Data buffer to be pushed.
+     * @param num_elements Number of elements in the buffer.
+     * @param timestamps One timestamp per frame, or empty.
      */
     template <typename T>
-    void push_stream(const std::vector<T> &buffer);
+    void push_stream(const T *buffer, std::size_t num_elements, std::span<const double> timestamps);
 
     /**
      * Pulls data from the LSL stream into a buffer.
      * @tparam T Type of the data in the buffer.
      * @param buffer Buffer to store the pulled data.
-     * @param timestamps Optional timestamps for the data.
+     * @param num_elements Capacity of the buffer in elements.
+     * @param timestamps Destination for one timestamp per frame, or empty.
+     * @return Number of elements written.
      */
     template <typename T>
-    void pull_stream(std::vector<T> &buffer, std::vector<double> *timestamps);
+    std::size_t pull_stream(T *buffer, std::size_t num_elements, std::span<double> timestamps);
 };
 
 #endif // HRI_PHYSIO_LSL_STREAMER_H
@@ -0,0 +1,86 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Shrikar Nakhye,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ * 
+ * Author: 
+ *     Shrikar Nakhye <shrikar.nakhye@smail.inf.h-brs.de>
+ * 
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+#include "mapped_file.h"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile() : mapped(nullptr), length(0) {}
+
+MappedFile::~MappedFile()
+{
+    this->close();
+}
+
+bool MappedFile::open(const std::string &path)
+{
+    this->close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cerr << "[WARNING] Could not open " << path << ": " << std::strerror(errno) << ".\n";
+        return false;
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0)
+    {
+        std::cerr << "[WARNING] Could not stat " << path << ": " << std::strerror(errno) << ".\n";
+        ::close(fd);
+        return false;
+    }
+
+    //-- An empty file cannot be mapped, but is a valid file without contents.
+    const std::size_t file_size = static_cast<std::size_t>(info.st_size);
+    if (file_size != 0)
+    {
+        void *data = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            std::cerr << "[WARNING] Could not map " << path << ": " << std::strerror(errno) << ".\n";
+            ::close(fd);
+            return false;
+        }
+        madvise(data, file_size, MADV_SEQUENTIAL);
+        mapped = static_cast<const char *>(data);
+    }
+    length = file_size;
+
+    //-- The mapping keeps the file alive on its own.
+    ::close(fd);
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (mapped != nullptr)
+    {
+        munmap(const_cast<char *>(mapped), length);
+    }
+    mapped = nullptr;
+    length = 0;
+}
+
+const char *MappedFile::data() const
+{
+    return mapped;
+}
+
+std::size_t MappedFile::size() const
+{
+    return length;
+}
@@ -0,0 +1,77 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Shrikar Nakhye,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ * 
+ * Author: 
+ *     Shrikar Nakhye <shrikar.nakhye@smail.inf.h-brs.de>
+ * 
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+#ifndef HRI_PHYSIO_MAPPED_FILE_H
+#define HRI_PHYSIO_MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief A whole file mapped read-only into memory, for the file readers.
+ */
+class MappedFile
+{
+private:
+    /**
+     * Start of the mapping, nullptr if nothing is mapped.
+     */
+    const char *mapped;
+
+    /**
+     * Size of the file in bytes.
+     */
+    std::size_t length;
+
+public:
+    /**
+     * Constructor to initialize an empty mapping.
+     */
+    MappedFile();
+
+    /**
+     * Destructor to unmap the file.
+     */
+    ~MappedFile();
+
+    /**
+     * Maps a file, replacing any file mapped before. The kernel is told the
+     * file will be read sequentially.
+     * @param path Path of the file.
+     * @return True if the file is mapped, false otherwise. An empty file maps
+     *     successfully with size() 0.
+     */
+    bool open(const std::string &path);
+
+    /**
+     * Unmaps the file.
+     */
+    void close();
+
+    /**
+     * Gets the start of the file's contents.
+     * @return Pointer to the first byte, nullptr for an empty file.
+     */
+    [[nodiscard]] const char *data() const;
+
+    /**
+     * Gets the size of the file.
+     * @return Size in bytes.
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    // Disallow copy and assignment operators.
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+};
+
+#endif // HRI_PHYSIO_MAPPED_FILE_H
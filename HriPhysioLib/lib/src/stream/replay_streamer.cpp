@@ -0,0 +1,307 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Shrikar Nakhye,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Shrikar Nakhye <shrikar.nakhye@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+#include "replay_streamer.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include "bin_streamer.h"
+#include "csv_streamer.h"
+#include "xdf_streamer.h"
+
+ReplayStreamer::ReplayStreamer() : StreamerInterface(),
+                                   speed(1.0),
+                                   chunk_frames(1024),
+                                   max_chunks(8),
+                                   finished(false),
+                                   stopping(false),
+                                   current_frame(0),
+                                   started(false),
+                                   paced_by_rate(false),
+                                   start_timestamp(0.0),
+                                   frames_replayed(0) {}
+
+ReplayStreamer::~ReplayStreamer()
+{
+    this->stop();
+}
+
+bool ReplayStreamer::open_input_stream()
+{
+    if (this->mode != ModeTag::NOT_SET)
+    {
+        return false;
+    }
+
+    std::string type = source_type;
+    if (type.empty())
+    {
+        type = std::filesystem::path(this->name).extension().string();
+        if (!type.empty())
+        {
+            type.erase(0, 1);
+        }
+    }
+    to_uppercase(type);
+
+    if (type == "CSV")
+    {
+        source = std::make_unique<CSVStreamer>();
+    }
+    else if (type == "BIN")
+    {
+        source = std::make_unique<BinStreamer>();
+    }
+    else if (type == "XDF")
+    {
+        source = std::make_unique<XDFStreamer>();
+    }
+    else
+    {
+        std::cerr << "[WARNING] ReplayStreamer cannot read recordings of type \"" << type << "\".\n";
+        return false;
+    }
+
+    //-- CSV recordings do not store their format, so pass on what the caller set.
+    source->set_name(this->name);
+    source->set_data_type(this->dtype);
+    source->set_num_channels(this->num_channels);
+    source->set_sampling_rate(this->sampling_rate);
+    if (!source->open_input_stream())
+    {
+        source.reset();
+        return false;
+    }
+
+    this->set_var_tag(source->get_var_tag());
+    this->num_channels = source->get_num_channels();
+    this->sampling_rate = source->get_sampling_rate();
+    if (!this->check_format() || this->element_size() == 0)
+    {
+        std::cerr << "[WARNING] ReplayStreamer replays numeric samples only.\n";
+        source.reset();
+        return false;
+    }
+
+    reader = std::thread(&ReplayStreamer::read_ahead, this);
+
+    this->set_mode(ModeTag::RECEIVER);
+    return true;
+}
+
+bool ReplayStreamer::open_output_stream()
+{
+    std::cerr << "[WARNING] ReplayStreamer only replays recordings; it cannot be an output.\n";
+    return false;
+}
+
+void ReplayStreamer::set_source_type(std::string new_source_type)
+{
+    this->source_type = std::move(new_source_type);
+}
+
+void ReplayStreamer::set_speed(double factor)
+{
+    this->speed = std::max(factor, as_fast_as_possible);
+}
+
+void ReplayStreamer::set_prefetch(std::size_t frames, std::size_t chunks)
+{
+    this->chunk_frames = std::max<std::size_t>(frames, 1);
+    this->max_chunks = std::max<std::size_t>(chunks, 1);
+}
+
+std::size_t ReplayStreamer::receive_buffer(void *buffer, std::size_t num_elements, std::span<double> timestamps)
+{
+    std::size_t num_frames = num_elements / this->num_channels;
+    if (!timestamps.empty())
+    {
+        num_frames = std::min(num_frames, timestamps.size());
+    }
+
+    const std::size_t frame_bytes = this->num_channels * this->element_size();
+    char *destination = static_cast<char *>(buffer);
+    auto now = std::chrono::steady_clock::time_point::min();
+    std::size_t frames = 0;
+
+    while (frames < num_frames)
+    {
+        //-- When paced, block for the first frame only; once some are copied, return what is buffered.
+        if (current_frame >= current.num_frames)
+        {
+            if (!this->next_chunk(frames == 0 || speed == as_fast_as_possible))
+            {
+                break;
+            }
+            continue;
+        }
+
+        //-- Frames of the current chunk that are due, sleeping only if none was copied yet.
+        const std::size_t available = std::min(current.num_frames - current_frame, num_frames - frames);
+        std::size_t run = available;
+        if (speed > as_fast_as_possible)
+        {
+            for (run = 0; run < available; ++run)
+            {
+                const auto due = this->due_time(current.timestamps[current_frame + run], frames_replayed + run);
+                if (due > now)
+                {
+                    now = std::chrono::steady_clock::now();
+                }
+                if (due > now)
+                {
+                    if (frames > 0 || run > 0)
+                    {
+                        break;
+                    }
+                    std::this_thread::sleep_until(due);
+                    now = due;
+                }
+            }
+            if (run == 0)
+            {
+                break;
+            }
+        }
+
+        std::memcpy(destination + frames * frame_bytes,
+                    current.samples.data() + current_frame * frame_bytes,
+                    run * frame_bytes);
+        if (!timestamps.empty())
+        {
+            std::copy_n(current.timestamps.begin() + static_cast<std::ptrdiff_t>(current_frame), run,
+                        timestamps.begin() + static_cast<std::ptrdiff_t>(frames));
+        }
+
+        current_frame += run;
+        frames_replayed += run;
+        frames += run;
+        if (run < available)
+        {
+            break;
+        }
+    }
+
+    return frames * this->num_channels;
+}
+
+void ReplayStreamer::read_ahead()
+{
+    const std::size_t frame_bytes = this->num_channels * this->element_size();
+
+    while (true)
+    {
+        Chunk chunk;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            if (stopping)
+            {
+                return;
+            }
+            if (!spare.empty())
+            {
+                chunk = std::move(spare.back());
+                spare.pop_back();
+            }
+        }
+
+        //-- A vector's storage comes from operator new, so it is aligned for every sample type.
+        chunk.samples.resize(chunk_frames * frame_bytes);
+        chunk.timestamps.resize(chunk_frames);
+        chunk.num_frames = receive_from(*source, chunk.samples.data(), chunk_frames * this->num_channels,
+                                        chunk.timestamps) /
+                           this->num_channels;
+
+        std::unique_lock<std::mutex> guard(lock);
+        if (chunk.num_frames == 0)
+        {
+            finished = true;
+            guard.unlock();
+            chunk_ready.notify_all();
+            return;
+        }
+
+        chunk_taken.wait(guard, [this]
+                         { return stopping || queue.size() < max_chunks; });
+        if (stopping)
+        {
+            return;
+        }
+        queue.push_back(std::move(chunk));
+        guard.unlock();
+        chunk_ready.notify_one();
+    }
+}
+
+bool ReplayStreamer::next_chunk(bool wait)
+{
+    std::unique_lock<std::mutex> guard(lock);
+    if (wait)
+    {
+        chunk_ready.wait(guard, [this]
+                         { return !queue.empty() || finished; });
+    }
+    if (queue.empty())
+    {
+        return false;
+    }
+
+    if (!current.samples.empty())
+    {
+        spare.push_back(std::move(current));
+    }
+    current = std::move(queue.front());
+    queue.pop_front();
+    current_frame = 0;
+
+    guard.unlock();
+    chunk_taken.notify_one();
+    return true;
+}
+
+std::chrono::steady_clock::time_point ReplayStreamer::due_time(double timestamp, std::uint64_t frame)
+{
+    if (!started)
+    {
+        started = true;
+        start_time = std::chrono::steady_clock::now();
+        start_timestamp = timestamp;
+    }
+
+    //-- Frames without timestamps read as 0, but a recording may also start at 0, so decide on the second frame.
+    if (frame == 1)
+    {
+        paced_by_rate = (start_timestamp == 0.0 && timestamp == 0.0 && this->sampling_rate > 0);
+    }
+
+    double elapsed = timestamp - start_timestamp;
+    if (paced_by_rate)
+    {
+        elapsed = static_cast<double>(frame) / static_cast<double>(this->sampling_rate);
+    }
+
+    const std::chrono::duration<double> offset(std::max(elapsed, 0.0) / speed);
+    return start_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset);
+}
+
+void ReplayStreamer::stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+    }
+    chunk_taken.notify_all();
+
+    if (reader.joinable())
+    {
+        reader.join();
+    }
+}
@@ -0,0 +1,206 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Shrikar Nakhye,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Shrikar Nakhye <shrikar.nakhye@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+#ifndef HRI_PHYSIO_REPLAY_STREAMER_H
+#define HRI_PHYSIO_REPLAY_STREAMER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "streamer_interface.h"
+
+/**
+ * @class ReplayStreamer
+ * @brief Plays a recorded session back as if it were a live stream.
+ *
+ * The recording is read by a CSV, BIN or XDF streamer on a separate I/O
+ * thread, which keeps a bounded queue of chunks filled ahead of the
+ * consumer. receive() then behaves like an LSL inlet: it waits until the
+ * next frame is due and returns every frame due by then. A frame is due
+ * when the wall-clock time since the first frame reaches the recorded time
+ * since the first frame divided by the speed factor. Recordings without
+ * timestamps, i.e. whose first two frames are both stamped 0, are paced by
+ * their nominal rate instead. A speed of
+ * as_fast_as_possible fills every receive() completely.
+ */
+class ReplayStreamer : public StreamerInterface
+{
+public:
+    /**
+     * Speed that disables pacing, for regression and throughput runs.
+     */
+    static constexpr double as_fast_as_possible = 0.0;
+
+private:
+    /**
+     * @struct Chunk
+     * @brief Frames read ahead by the I/O thread.
+     */
+    struct Chunk
+    {
+        std::vector<char> samples;
+        std::vector<double> timestamps;
+        std::size_t num_frames = 0;
+    };
+
+    /**
+     * Streamer reading the recording.
+     */
+    std::unique_ptr<StreamerInterface> source;
+
+    /**
+     * Format of the recording, taken from the file extension when empty.
+     */
+    std::string source_type;
+
+    /**
+     * Replay speed relative to the recording, as_fast_as_possible to disable pacing.
+     */
+    double speed;
+
+    /**
+     * Frames read per chunk, and chunks the I/O thread may read ahead.
+     */
+    std::size_t chunk_frames;
+    std::size_t max_chunks;
+
+    /**
+     * Chunks read ahead, and emptied chunks kept for reuse.
+     */
+    std::deque<Chunk> queue;
+    std::vector<Chunk> spare;
+
+    /**
+     * Mutex guarding the queues and flags, signalled when a chunk is queued or taken.
+     */
+    std::mutex lock;
+    std::condition_variable chunk_ready;
+    std::condition_variable chunk_taken;
+
+    /**
+     * Flags set when the recording is exhausted and when the streamer is closing.
+     */
+    bool finished;
+    bool stopping;
+
+    /**
+     * I/O thread reading the recording.
+     */
+    std::thread reader;
+
+    /**
+     * Chunk being replayed and the next frame in it.
+     */
+    Chunk current;
+    std::size_t current_frame;
+
+    /**
+     * Wall-clock time and recorded timestamp of the first frame, and frames replayed so far.
+     */
+    bool started;
+    bool paced_by_rate;
+    std::chrono::steady_clock::time_point start_time;
+    double start_timestamp;
+    std::uint64_t frames_replayed;
+
+public:
+    /**
+     * Constructor to initialize the ReplayStreamer at recorded speed.
+     */
+    ReplayStreamer();
+
+    /**
+     * Destructor stops and joins the I/O thread.
+     */
+    ~ReplayStreamer();
+
+    /**
+     * Opens the recording and starts reading ahead. The data type, channel
+     * count and rate are taken from the recording when it stores them; CSV
+     * recordings need set_data_type() and set_num_channels() first.
+     * @return True if the recording was opened, false otherwise.
+     */
+    bool open_input_stream() override;
+
+    /**
+     * Replay is input only.
+     * @return False.
+     */
+    bool open_output_stream() override;
+
+    /**
+     * Sets the format of the recording instead of deducing it from the file extension.
+     * @param new_source_type "CSV", "BIN" or "XDF".
+     */
+    void set_source_type(std::string new_source_type);
+
+    /**
+     * Sets the replay speed, e.g. 10 for ten times faster than recorded.
+     * Must be called before open_input_stream().
+     * @param factor Speed relative to the recording, as_fast_as_possible to disable pacing.
+     */
+    void set_speed(double factor);
+
+    /**
+     * Sets how far the I/O thread reads ahead.
+     * @param frames Frames read per chunk.
+     * @param chunks Chunks kept in the queue.
+     */
+    void set_prefetch(std::size_t frames, std::size_t chunks);
+
+protected:
+    /**
+     * Waits for the next frame to be due and copies every frame due by then.
+     * @param buffer Destination for elements of the stream's data type.
+     * @param num_elements Capacity of the destination in elements.
+     * @param timestamps Destination for the recorded timestamp of each frame, or empty.
+     * @return Number of elements written, 0 at the end of the recording.
+     */
+    std::size_t receive_buffer(void *buffer, std::size_t num_elements, std::span<double> timestamps) override;
+
+private:
+    /**
+     * Body of the I/O thread.
+     */
+    void read_ahead();
+
+    /**
+     * Replaces the current chunk with the next queued one, waiting for it if needed.
+     * @param wait False to return at once if no chunk is queued.
+     * @return True if a chunk was taken, false otherwise.
+     */
+    bool next_chunk(bool wait);
+
+    /**
+     * Gets the wall-clock time a frame is due at.
+     * @param timestamp Recorded timestamp of the frame.
+     * @param frame Position of the frame in the recording.
+     * @return Time to deliver the frame at.
+     */
+    std::chrono::steady_clock::time_point due_time(double timestamp, std::uint64_t frame);
+
+    /**
+     * Stops and joins the I/O thread.
+     */
+    void stop();
+
+    // Disallow copy and assignment operators.
+    ReplayStreamer(const ReplayStreamer &) = delete;
+    ReplayStreamer &operator=(const ReplayStreamer &) = delete;
+};
+
+#endif // HRI_PHYSIO_REPLAY_STREAMER_H
@@ -0,0 +1,468 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Shrikar Nakhye,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Shrikar Nakhye <shrikar.nakhye@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+#include "shm_streamer.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+struct ShmStreamer::Header
+{
+    char magic[8];
+    std::uint32_t var;
+    std::uint32_t num_channels;
+    std::uint64_t sampling_rate;
+    std::uint64_t capacity;
+    std::uint64_t frame_bytes;
+
+    //-- Set by the sender once the fields above are written, and when it closes.
+    std::atomic<std::uint32_t> ready;
+    std::atomic<std::uint32_t> closed;
+
+    //-- Claimed by the receiver, so a second one cannot attach.
+    std::atomic<std::uint32_t> attached;
+
+    //-- Written by the sender: frames published, and the futex word bumped to wake the receiver.
+    alignas(64) std::atomic<std::uint64_t> tail;
+    std::atomic<std::uint32_t> wake;
+
+    //-- Written by the receiver: frames consumed, and whether it is about to sleep on wake.
+    alignas(64) std::atomic<std::uint64_t> head;
+    std::atomic<std::uint32_t> sleeping;
+};
+
+namespace
+{
+    constexpr char magic[8] = {'H', 'R', 'I', 'P', 'S', 'H', 'M', 1};
+
+    //-- The counters are shared between processes, so they must not fall back to a lock.
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+
+    std::string segment_for(const std::string &stream)
+    {
+        std::string segment = "/hri_physio_" + stream;
+        std::replace(segment.begin() + 1, segment.end(), '/', '_');
+        return segment;
+    }
+
+#ifdef __linux__
+    std::size_t page_size()
+    {
+        return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    //-- Not FUTEX_PRIVATE_FLAG: the word lives in memory shared with another process.
+    long futex(std::atomic<std::uint32_t> &word, int op, std::uint32_t value, const timespec *timeout)
+    {
+        return syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), op, value, timeout, nullptr, 0);
+    }
+#endif
+}
+
+ShmStreamer::ShmStreamer() : StreamerInterface(),
+                             header(nullptr),
+                             mapping(nullptr),
+                             mapping_size(0),
+                             timestamps_ring(nullptr),
+                             frames_ring(nullptr),
+                             capacity(4096),
+                             frame_bytes(0),
+                             timeout(5.0),
+                             own_position(0),
+                             cached_position(0),
+                             dropped_frames(0) {}
+
+ShmStreamer::~ShmStreamer()
+{
+    if (header == nullptr)
+    {
+        return;
+    }
+
+#ifdef __linux__
+    if (this->mode == ModeTag::SENDER)
+    {
+        header->closed.store(1, std::memory_order_release);
+        header->wake.fetch_add(1);
+        futex(header->wake, FUTEX_WAKE, INT_MAX, nullptr);
+        shm_unlink(segment_name.c_str());
+    }
+    else if (this->mode == ModeTag::RECEIVER)
+    {
+        header->attached.store(0, std::memory_order_release);
+    }
+#endif
+
+    this->unmap_segment();
+}
+
+bool ShmStreamer::open_input_stream()
+{
+    if (this->mode != ModeTag::NOT_SET)
+    {
+        return false;
+    }
+
+#ifdef __linux__
+    segment_name = segment_for(this->name);
+    const std::size_t page = page_size();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+
+    //-- The sender may start later, so wait for its segment to be created and sized, then for its header.
+    int fd = -1;
+    struct stat status{};
+    while ((fd = shm_open(segment_name.c_str(), O_RDWR, 0)) < 0 ||
+           fstat(fd, &status) != 0 || static_cast<std::size_t>(status.st_size) < page)
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            std::cerr << "[WARNING] No sender for shared-memory stream " << this->name << ".\n";
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    void *first_page = mmap(nullptr, page, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (first_page == MAP_FAILED)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    const auto *shared = static_cast<const Header *>(first_page);
+    while (shared->ready.load(std::memory_order_acquire) == 0 && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    bool valid = shared->ready.load(std::memory_order_acquire) != 0 &&
+                 std::memcmp(shared->magic, magic, sizeof(magic)) == 0;
+    capacity = shared->capacity;
+    frame_bytes = shared->frame_bytes;
+    munmap(first_page, page);
+
+    valid = valid && std::has_single_bit(capacity) && fstat(fd, &status) == 0 &&
+            static_cast<std::size_t>(status.st_size) >= page + capacity * (sizeof(double) + frame_bytes);
+
+    if (!valid || !this->map_segment(fd))
+    {
+        std::cerr << "[WARNING] " << segment_name << " is not a shared-memory stream.\n";
+        ::close(fd);
+        return false;
+    }
+    ::close(fd);
+
+    if (header->attached.exchange(1) != 0)
+    {
+        std::cerr << "[WARNING] Shared-memory stream " << this->name << " already has a receiver.\n";
+        this->unmap_segment();
+        return false;
+    }
+
+    this->set_var_tag(static_cast<VarTag>(header->var));
+    this->num_channels = header->num_channels;
+    this->sampling_rate = header->sampling_rate;
+    own_position = header->head.load(std::memory_order_acquire);
+    cached_position = header->tail.load(std::memory_order_acquire);
+
+    this->set_mode(ModeTag::RECEIVER);
+    return true;
+#else
+    std::cerr << "[WARNING] Shared-memory streams are only supported on Linux.\n";
+    return false;
+#endif
+}
+
+bool ShmStreamer::open_output_stream()
+{
+    if (this->mode != ModeTag::NOT_SET || !this->check_format())
+    {
+        return false;
+    }
+
+    if (this->element_size() == 0)
+    {
+        std::cerr << "[WARNING] ShmStreamer carries numeric samples, not " << this->dtype << ".\n";
+        return false;
+    }
+
+#ifdef __linux__
+    segment_name = segment_for(this->name);
+    frame_bytes = this->num_channels * this->element_size();
+    capacity = std::bit_ceil(std::max(capacity, page_size()));
+
+    //-- Remove a segment left behind by a sender that crashed; a receiver still attached to it sees no more data.
+    shm_unlink(segment_name.c_str());
+    int fd = shm_open(segment_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+    {
+        std::cerr << "[WARNING] Could not create shared-memory stream " << segment_name << ".\n";
+        return false;
+    }
+
+    const std::size_t size = page_size() + capacity * (sizeof(double) + frame_bytes);
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0 || !this->map_segment(fd))
+    {
+        std::cerr << "[WARNING] Could not map shared-memory stream " << segment_name << ".\n";
+        ::close(fd);
+        shm_unlink(segment_name.c_str());
+        return false;
+    }
+    ::close(fd);
+
+    header = new (mapping) Header();
+    std::memcpy(header->magic, magic, sizeof(magic));
+    header->var = static_cast<std::uint32_t>(this->var);
+    header->num_channels = static_cast<std::uint32_t>(this->num_channels);
+    header->sampling_rate = this->sampling_rate;
+    header->capacity = capacity;
+    header->frame_bytes = frame_bytes;
+    header->ready.store(1, std::memory_order_release);
+
+    own_position = 0;
+    cached_position = 0;
+
+    this->set_mode(ModeTag::SENDER);
+    return true;
+#else
+    std::cerr << "[WARNING] Shared-memory streams are only supported on Linux.\n";
+    return false;
+#endif
+}
+
+void ShmStreamer::set_capacity(std::size_t frames)
+{
+    this->capacity = frames;
+}
+
+void ShmStreamer::set_timeout(double seconds)
+{
+    this->timeout = seconds;
+}
+
+std::uint64_t ShmStreamer::get_dropped_frames() const
+{
+    return this->dropped_frames;
+}
+
+bool ShmStreamer::consume(std::size_t num_frames)
+{
+    if (this->mode != ModeTag::RECEIVER)
+    {
+        return false;
+    }
+
+    if (own_position + num_frames > cached_position)
+    {
+        cached_position = header->tail.load(std::memory_order_acquire);
+        if (own_position + num_frames > cached_position)
+        {
+            return false;
+        }
+    }
+
+    own_position += num_frames;
+    header->head.store(own_position, std::memory_order_release);
+    return true;
+}
+
+bool ShmStreamer::publish_buffer(const void *buffer, std::size_t num_elements, std::span<const double> timestamps)
+{
+    std::size_t num_frames = num_elements / this->num_channels;
+    if (!timestamps.empty())
+    {
+        num_frames = std::min(num_frames, timestamps.size());
+    }
+    if (num_frames == 0)
+    {
+        return true;
+    }
+
+    //-- Only look at the receiver's counter when the last view of it says the ring is full.
+    if (own_position + num_frames - cached_position > capacity)
+    {
+        cached_position = header->head.load(std::memory_order_acquire);
+        if (own_position + num_frames - cached_position > capacity)
+        {
+            dropped_frames += num_frames;
+            return false;
+        }
+    }
+
+    //-- The second mapping takes care of the wrap.
+    const std::size_t slot = own_position & (capacity - 1);
+    std::memcpy(frames_ring + slot * frame_bytes, buffer, num_frames * frame_bytes);
+    if (timestamps.empty())
+    {
+        std::fill_n(timestamps_ring + slot, num_frames, 0.0);
+    }
+    else
+    {
+        std::memcpy(timestamps_ring + slot, timestamps.data(), num_frames * sizeof(double));
+    }
+
+    //-- Sequentially consistent, paired with the receiver announcing that it sleeps before rechecking the tail.
+    own_position += num_frames;
+    header->tail.store(own_position);
+#ifdef __linux__
+    if (header->sleeping.load() != 0)
+    {
+        header->wake.fetch_add(1);
+        futex(header->wake, FUTEX_WAKE, 1, nullptr);
+    }
+#endif
+    return true;
+}
+
+std::size_t ShmStreamer::receive_buffer(void *buffer, std::size_t num_elements, std::span<double> timestamps)
+{
+    std::size_t num_frames = num_elements / this->num_channels;
+    if (!timestamps.empty())
+    {
+        num_frames = std::min(num_frames, timestamps.size());
+    }
+
+    num_frames = std::min(num_frames, this->wait_for_frames());
+    const std::size_t slot = own_position & (capacity - 1);
+    std::memcpy(buffer, frames_ring + slot * frame_bytes, num_frames * frame_bytes);
+    if (!timestamps.empty())
+    {
+        std::memcpy(timestamps.data(), timestamps_ring + slot, num_frames * sizeof(double));
+    }
+
+    this->consume(num_frames);
+    return num_frames * this->num_channels;
+}
+
+std::size_t ShmStreamer::wait_for_frames()
+{
+    cached_position = header->tail.load(std::memory_order_acquire);
+    if (cached_position != own_position)
+    {
+        return cached_position - own_position;
+    }
+
+#ifdef __linux__
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(timeout);
+    while (true)
+    {
+        //-- Announce the sleep before rechecking, so a publish in between either is seen or wakes us.
+        const std::uint32_t wake = header->wake.load();
+        header->sleeping.store(1);
+        if (header->tail.load() != own_position || header->closed.load(std::memory_order_acquire) != 0)
+        {
+            break;
+        }
+
+        const auto remaining = deadline - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::steady_clock::duration::zero())
+        {
+            break;
+        }
+
+        const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(remaining);
+        const timespec wait = {static_cast<time_t>(seconds.count()),
+                               static_cast<long>(std::chrono::duration_cast<std::chrono::nanoseconds>(remaining - seconds).count())};
+        futex(header->wake, FUTEX_WAIT, wake, &wait);
+    }
+    header->sleeping.store(0, std::memory_order_relaxed);
+#endif
+
+    cached_position = header->tail.load(std::memory_order_acquire);
+    return cached_position - own_position;
+}
+
+bool ShmStreamer::map_segment(int fd)
+{
+    static_assert(sizeof(Header) <= 4096, "The header must fit in the first page of the segment.");
+
+#ifdef __linux__
+    const std::size_t page = page_size();
+    const std::size_t timestamp_bytes = capacity * sizeof(double);
+    const std::size_t ring_bytes = capacity * frame_bytes;
+    const std::size_t size = page + 2 * timestamp_bytes + 2 * ring_bytes;
+
+    //-- Reserve the full range first so each ring's two copies land next to each other.
+    void *base = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED)
+    {
+        return false;
+    }
+
+    struct Part
+    {
+        std::size_t at;
+        std::size_t length;
+        std::size_t offset;
+    };
+    const Part parts[] = {
+        {0, page, 0},
+        {page, timestamp_bytes, page},
+        {page + timestamp_bytes, timestamp_bytes, page},
+        {page + 2 * timestamp_bytes, ring_bytes, page + timestamp_bytes},
+        {page + 2 * timestamp_bytes + ring_bytes, ring_bytes, page + timestamp_bytes},
+    };
+
+    auto *bytes = static_cast<char *>(base);
+    for (const Part &part : parts)
+    {
+        if (mmap(bytes + part.at, part.length, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED,
+                 fd, static_cast<off_t>(part.offset)) == MAP_FAILED)
+        {
+            munmap(base, size);
+            return false;
+        }
+    }
+
+    mapping = base;
+    mapping_size = size;
+    header = static_cast<Header *>(base);
+    timestamps_ring = reinterpret_cast<double *>(bytes + page);
+    frames_ring = bytes + page + 2 * timestamp_bytes;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void ShmStreamer::unmap_segment()
+{
+#ifdef __linux__
+    if (mapping != nullptr)
+    {
+        munmap(mapping, mapping_size);
+    }
+#endif
+    mapping = nullptr;
+    mapping_size = 0;
+    header = nullptr;
+    timestamps_ring = nullptr;
+    frames_ring = nullptr;
+}
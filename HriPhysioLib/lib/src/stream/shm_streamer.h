@@ -0,0 +1,206 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Shrikar Nakhye,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Shrikar Nakhye <shrikar.nakhye@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+#ifndef HRI_PHYSIO_SHM_STREAMER_H
+#define HRI_PHYSIO_SHM_STREAMER_H
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include "streamer_interface.h"
+
+/**
+ * @class ShmStreamer
+ * @brief Moves samples between processes on one host through a shared-memory ring.
+ *
+ * The sender creates a POSIX shared-memory segment named after the stream
+ * holding a header, a ring of timestamps and a ring of frames. Each ring is
+ * mapped twice back-to-back, as in MirroredRingBuffer, so any run of frames
+ * is contiguous. publish() is a memcpy and an atomic store; it only makes a
+ * futex syscall when the receiver sleeps. peek() hands out a pointer into
+ * the ring, and consume() frees the frames; receive() copies instead.
+ * There is one sender and one receiver per stream. A full ring rejects the
+ * publish, like SpscRingBuffer, and counts the dropped frames. Linux only.
+ */
+class ShmStreamer : public StreamerInterface
+{
+    /**
+     * Layout of the start of the segment, defined in the source file.
+     */
+    struct Header;
+
+    /**
+     * Header of the segment, nullptr when not open.
+     */
+    Header *header;
+
+    /**
+     * Start and size of the whole mapping.
+     */
+    void *mapping;
+    std::size_t mapping_size;
+
+    /**
+     * Mirrored rings of timestamps and interleaved frames.
+     */
+    double *timestamps_ring;
+    char *frames_ring;
+
+    /**
+     * Ring length in frames, a power of two of at least one page.
+     */
+    std::size_t capacity;
+
+    /**
+     * Bytes per frame.
+     */
+    std::size_t frame_bytes;
+
+    /**
+     * Shared-memory object name, derived from the stream name.
+     */
+    std::string segment_name;
+
+    /**
+     * Seconds receive() and open_input_stream() wait before giving up.
+     */
+    double timeout;
+
+    /**
+     * Each side's copy of the counter it owns, and its last view of the other side's.
+     */
+    std::uint64_t own_position;
+    std::uint64_t cached_position;
+
+    /**
+     * Frames rejected because the ring was full.
+     */
+    std::uint64_t dropped_frames;
+
+public:
+    /**
+     * Constructor to initialize the ShmStreamer.
+     */
+    ShmStreamer();
+
+    /**
+     * Destructor unmaps the segment; the sender also marks it closed and removes its name.
+     */
+    ~ShmStreamer();
+
+    /**
+     * Attaches to the segment of a sender, waiting up to the timeout for it
+     * to appear. The data type, channel count and rate are the sender's.
+     * @return True if attached, false otherwise.
+     */
+    bool open_input_stream() override;
+
+    /**
+     * Creates the segment, replacing one left behind by a previous sender.
+     * @return True if the segment was created, false otherwise.
+     */
+    bool open_output_stream() override;
+
+    /**
+     * Sets the ring length. Must be called before open_output_stream().
+     * @param frames Minimum number of frames, rounded up to a power of two of at least one page.
+     */
+    void set_capacity(std::size_t frames);
+
+    /**
+     * Sets how long receiving waits for the sender.
+     * @param seconds Timeout in seconds.
+     */
+    void set_timeout(double seconds);
+
+    /**
+     * Gets the number of frames rejected because the ring was full.
+     * @return Dropped frames.
+     */
+    [[nodiscard]] std::uint64_t get_dropped_frames() const;
+
+    /**
+     * Waits for frames and returns them in place, without copying.
+     * @tparam T Element type, must match the stream's data type.
+     * @param timestamps Set to one timestamp per frame if not nullptr.
+     * @return Interleaved elements of every frame available, empty on timeout
+     *     or once the sender closed and the ring is drained.
+     */
+    template <class T>
+    std::span<const T> peek(std::span<const double> *timestamps = nullptr)
+    {
+        if (this->mode != ModeTag::RECEIVER || var_tag_of<T>() != this->var)
+        {
+            std::cerr << "[WARNING] Stream " << this->name << " is not open for receiving " << this->dtype << ".\n";
+            return {};
+        }
+
+        const std::size_t num_frames = this->wait_for_frames();
+        const std::size_t slot = own_position & (capacity - 1);
+        if (timestamps != nullptr)
+        {
+            *timestamps = std::span<const double>(timestamps_ring + slot, num_frames);
+        }
+        return std::span<const T>(reinterpret_cast<const T *>(frames_ring + slot * frame_bytes),
+                                  num_frames * this->num_channels);
+    }
+
+    /**
+     * Frees frames returned by peek() for the sender to overwrite.
+     * @param num_frames Number of frames to free, oldest first.
+     * @return True if that many frames were available, false otherwise.
+     */
+    bool consume(std::size_t num_frames);
+
+protected:
+    /**
+     * Copies the frames into the ring with their timestamps, 0 if none are given.
+     * @param buffer Elements of the stream's data type.
+     * @param num_elements Number of elements in the buffer.
+     * @param timestamps One timestamp per frame, or empty.
+     * @return True if the frames fit, false if the ring was full.
+     */
+    bool publish_buffer(const void *buffer, std::size_t num_elements, std::span<const double> timestamps) override;
+
+    /**
+     * Waits for frames and copies as many as fit out of the ring.
+     * @param buffer Destination for elements of the stream's data type.
+     * @param num_elements Capacity of the destination in elements.
+     * @param timestamps Destination for one timestamp per frame, or empty.
+     * @return Number of elements written, 0 on timeout or end of stream.
+     */
+    std::size_t receive_buffer(void *buffer, std::size_t num_elements, std::span<double> timestamps) override;
+
+private:
+    /**
+     * Waits up to the timeout for the sender to publish.
+     * @return Number of frames available from own_position.
+     */
+    std::size_t wait_for_frames();
+
+    /**
+     * Maps the segment with both rings mirrored.
+     * @param fd Shared-memory object.
+     * @return True if mapped, false otherwise.
+     */
+    bool map_segment(int fd);
+
+    /**
+     * Unmaps the segment.
+     */
+    void unmap_segment();
+
+    // Disallow copy and assignment operators.
+    ShmStreamer(const ShmStreamer &) = delete;
+    ShmStreamer &operator=(const ShmStreamer &) = delete;
+};
+
+#endif // HRI_PHYSIO_SHM_STREAMER_H
@@ -42,6 +42,26 @@ StreamerInterface *StreamerFactory::get_streamer(std::string streamer_type)
         return new CSVStreamer();
     }
 
+    if (streamer_type == "BIN")
+    {
+        return new BinStreamer();
+    }
+
+    if (streamer_type == "XDF")
+    {
+        return new XDFStreamer();
+    }
+
+    if (streamer_type == "REPLAY")
+    {
+        return new ReplayStreamer();
+    }
+
+    if (streamer_type == "SHM")
+    {
+        return new ShmStreamer();
+    }
+
     std::cerr << "[WARNING] StreamerFactory received unknown type: "
               << streamer_type
               << std::endl;
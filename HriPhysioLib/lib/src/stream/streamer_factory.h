@@ -28,6 +28,10 @@
 #include "streamer_interface.h"
 #include "lsl_streamer.h"
 #include "csv_streamer.h"
+#include "bin_streamer.h"
+#include "xdf_streamer.h"
+#include "replay_streamer.h"
+#include "shm_streamer.h"
 #include "../utilities/helpers.h"
 
 /**
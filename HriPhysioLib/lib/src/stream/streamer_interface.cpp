@@ -23,9 +23,26 @@
  */
 #include "streamer_interface.h"
 
-StreamerInterface::StreamerInterface() : frame_length(0), num_channels(0), sampling_rate(0),
-                                         var(VarTag::CHAR),
-                                         mode(ModeTag::NOT_SET) {}
+namespace
+{
+    //-- Data type names accepted in configs, and their tags.
+    const std::unordered_map<std::string, VarTag> string_to_var_tag = {
+        {"INT8", VarTag::CHAR},
+        {"CHAR", VarTag::CHAR},
+        {"INT16", VarTag::INT16},
+        {"INT32", VarTag::INT32},
+        {"INT64", VarTag::INT64},
+        {"FLOAT", VarTag::FLOAT},
+        {"FLOAT32", VarTag::FLOAT},
+        {"DOUBLE", VarTag::DOUBLE},
+        {"DOUBLE64", VarTag::DOUBLE},
+        {"STRING", VarTag::STRING},
+    };
+}
+
+StreamerInterface::StreamerInterface() : var(VarTag::CHAR),
+                                         mode(ModeTag::NOT_SET),
+                                         dtype("CHAR"), frame_length(0), num_channels(0), sampling_rate(0) {}
 
 void StreamerInterface::set_mode(ModeTag new_mode)
 {
@@ -37,31 +54,122 @@ void StreamerInterface::set_name(std::string new_name)
     this->name = new_name;
 }
 
-void StreamerInterface::set_data_type(std::string dtype_tag)
+bool StreamerInterface::set_data_type(std::string dtype_tag)
 {
     dtype_tag = to_uppercase(dtype_tag);
-
-    static const std::unordered_map<std::string, VarTag> string_to_var_tag = {
-        {"INT8", VarTag::CHAR},
-        {"CHAR", VarTag::CHAR},
-        {"INT16", VarTag::INT16},
-        {"INT32", VarTag::INT32},
-        {"INT64", VarTag::INT64},
-        {"FLOAT", VarTag::FLOAT},
-        {"FLOAT32", VarTag::FLOAT},
-        {"DOUBLE", VarTag::DOUBLE},
-        {"DOUBLE64", VarTag::DOUBLE},
-        {"STRING", VarTag::STRING},
-    };
+    this->dtype = dtype_tag;
 
     auto candidate = string_to_var_tag.find(dtype_tag);
-    if (candidate != string_to_var_tag.end())
+    if (candidate == string_to_var_tag.end())
     {
-        this->var = candidate->second;
+        std::cerr << "[WARNING] Unknown data type \"" << dtype_tag << "\" for stream " << this->name << ".\n";
+        return false;
     }
+
+    this->var = candidate->second;
+    return true;
 }
 
 void StreamerInterface::set_num_channels(std::size_t new_num_channels)
 {
     this->num_channels = new_num_channels;
 }
+
+void StreamerInterface::set_sampling_rate(std::size_t new_sampling_rate)
+{
+    this->sampling_rate = new_sampling_rate;
+}
+
+VarTag StreamerInterface::get_var_tag() const
+{
+    return this->var;
+}
+
+std::size_t StreamerInterface::get_num_channels() const
+{
+    return this->num_channels;
+}
+
+std::size_t StreamerInterface::get_sampling_rate() const
+{
+    return this->sampling_rate;
+}
+
+void StreamerInterface::set_var_tag(VarTag tag)
+{
+    static const std::unordered_map<VarTag, std::string> var_tag_to_string = {
+        {VarTag::CHAR, "INT8"},
+        {VarTag::INT16, "INT16"},
+        {VarTag::INT32, "INT32"},
+        {VarTag::INT64, "INT64"},
+        {VarTag::FLOAT, "FLOAT"},
+        {VarTag::DOUBLE, "DOUBLE"},
+        {VarTag::STRING, "STRING"},
+    };
+
+    auto candidate = var_tag_to_string.find(tag);
+    this->var = tag;
+    this->dtype = (candidate != var_tag_to_string.end()) ? candidate->second : "";
+}
+
+std::size_t StreamerInterface::element_size() const
+{
+    switch (this->var)
+    {
+    case VarTag::CHAR:
+        return sizeof(char);
+    case VarTag::INT16:
+        return sizeof(int16_t);
+    case VarTag::INT32:
+        return sizeof(int32_t);
+    case VarTag::INT64:
+    case VarTag::LONG_LONG:
+        return sizeof(int64_t);
+    case VarTag::FLOAT:
+        return sizeof(float);
+    case VarTag::DOUBLE:
+        return sizeof(double);
+    default:
+        return 0;
+    }
+}
+
+bool StreamerInterface::check_format() const
+{
+    if (string_to_var_tag.find(this->dtype) == string_to_var_tag.end())
+    {
+        std::cerr << "[WARNING] Cannot open stream " << this->name << " with unknown data type "
+                  << this->dtype << ".\n";
+        return false;
+    }
+
+    if (this->num_channels == 0)
+    {
+        std::cerr << "[WARNING] Cannot open stream " << this->name << " without channels.\n";
+        return false;
+    }
+
+    return true;
+}
+
+bool StreamerInterface::publish_buffer(const void *, std::size_t, std::span<const double>)
+{
+    std::cerr << "[WARNING] Stream " << this->name << " does not support publishing samples.\n";
+    return false;
+}
+
+std::size_t StreamerInterface::receive_buffer(void *, std::size_t, std::span<double>)
+{
+    std::cerr << "[WARNING] Stream " << this->name << " does not support receiving samples.\n";
+    return 0;
+}
+
+std::size_t StreamerInterface::receive_from(StreamerInterface &source, void *buffer, std::size_t num_elements, std::span<double> timestamps)
+{
+    if (source.mode != ModeTag::RECEIVER)
+    {
+        std::cerr << "[WARNING] Stream " << source.name << " is not open for receiving.\n";
+        return 0;
+    }
+    return source.receive_buffer(buffer, num_elements, timestamps);
+}
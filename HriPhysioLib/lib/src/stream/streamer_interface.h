@@ -24,12 +24,54 @@
 #ifndef HRI_PHYSIO_STREAMER_INTERFACE_H
 #define HRI_PHYSIO_STREAMER_INTERFACE_H
 
+#include <cstdint>
 #include <iostream>
+#include <ranges>
+#include <span>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include "../utilities/enums.h"
 #include "../utilities/helpers.h"
 
+/**
+ * Maps a C++ element type to the VarTag of a stream carrying it.
+ * @tparam T Signed integer or floating point type.
+ * @return VarTag matching the type.
+ */
+template <typename T>
+constexpr VarTag var_tag_of()
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        return VarTag::FLOAT;
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        return VarTag::DOUBLE;
+    }
+    else if constexpr (std::is_same_v<T, char> || (std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 1))
+    {
+        return VarTag::CHAR;
+    }
+    else if constexpr (std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 2)
+    {
+        return VarTag::INT16;
+    }
+    else if constexpr (std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 4)
+    {
+        return VarTag::INT32;
+    }
+    else if constexpr (std::is_integral_v<T> && std::is_signed_v<T> && sizeof(T) == 8)
+    {
+        return VarTag::INT64;
+    }
+    else
+    {
+        static_assert(sizeof(T) == 0, "Streams carry signed integers, float or double.");
+    }
+}
+
 /**
  * @class StreamerInterface
  * @brief Base class for streaming data with various configurations.
@@ -78,12 +120,116 @@ protected:
      */
     void set_mode(ModeTag new_mode);
 
+    /**
+     * Sets the data type from a tag, e.g. one read from a recording.
+     * @param tag Data type of the stream.
+     */
+    void set_var_tag(VarTag tag);
+
+    /**
+     * Gets the size of one sample of the stream's data type.
+     * @return Size in bytes, 0 for strings.
+     */
+    [[nodiscard]] std::size_t element_size() const;
+
+    /**
+     * Checks the data type and channel count before a stream is opened, so
+     * publish and receive only need to compare a tag.
+     * @return True if the format can be streamed, false otherwise.
+     */
+    bool check_format() const;
+
+    /**
+     * Publishes interleaved elements whose type matches the stream's VarTag.
+     * @param buffer Elements, num_channels per frame.
+     * @param num_elements Number of elements in the buffer.
+     * @param timestamps One timestamp per frame, or empty.
+     * @return True if the buffer was published, false otherwise.
+     */
+    virtual bool publish_buffer(const void *buffer, std::size_t num_elements, std::span<const double> timestamps);
+
+    /**
+     * Receives interleaved elements whose type matches the stream's VarTag.
+     * @param buffer Destination for the elements.
+     * @param num_elements Capacity of the destination in elements.
+     * @param timestamps Destination for one timestamp per frame, or empty.
+     * @return Number of elements written.
+     */
+    virtual std::size_t receive_buffer(void *buffer, std::size_t num_elements, std::span<double> timestamps);
+
+    /**
+     * Receives from another streamer without knowing its element type, for
+     * streamers that wrap one, e.g. to replay a recording.
+     * @param source Streamer opened for receiving.
+     * @param buffer Destination for the elements, aligned for the source's data type.
+     * @param num_elements Capacity of the destination in elements.
+     * @param timestamps Destination for one timestamp per frame, or empty.
+     * @return Number of elements written.
+     */
+    static std::size_t receive_from(StreamerInterface &source, void *buffer, std::size_t num_elements, std::span<double> timestamps);
+
 public:
     /**
      * Constructor to initialize the StreamerInterface.
      */
     StreamerInterface();
 
+    /**
+     * Destructor, virtual so streamers from the factory can be deleted through this class.
+     */
+    virtual ~StreamerInterface() = default;
+
+    /**
+     * Opens the stream for receiving.
+     * @return True if the stream is successfully opened, false otherwise.
+     */
+    virtual bool open_input_stream() = 0;
+
+    /**
+     * Opens the stream for sending.
+     * @return True if the stream is successfully opened, false otherwise.
+     */
+    virtual bool open_output_stream() = 0;
+
+    /**
+     * Publishes frames of interleaved samples, e.g. a std::vector or std::span.
+     * The element type must match the data type the stream was opened with.
+     * @param buffer Contiguous samples, num_channels per frame.
+     * @param timestamps One timestamp per frame, or empty.
+     * @return True if the buffer was published, false otherwise.
+     */
+    template <std::ranges::contiguous_range Range>
+    bool publish(const Range &buffer, std::span<const double> timestamps = {})
+    {
+        using T = std::remove_cv_t<std::ranges::range_value_t<Range>>;
+        if (this->mode != ModeTag::SENDER || var_tag_of<T>() != this->var)
+        {
+            std::cerr << "[WARNING] Stream " << this->name << " is not open for sending " << this->dtype << ".\n";
+            return false;
+        }
+        return this->publish_buffer(std::ranges::data(buffer), std::ranges::size(buffer), timestamps);
+    }
+
+    /**
+     * Receives frames of interleaved samples into a caller-owned buffer, which
+     * is filled but never resized, so steady-state receiving does not allocate.
+     * The element type must match the data type the stream was opened with.
+     * @param buffer Destination, e.g. a presized std::vector or a std::span.
+     * @param timestamps Destination for one timestamp per frame, or empty.
+     * @return Number of elements written, a multiple of num_channels.
+     */
+    template <std::ranges::contiguous_range Range>
+    std::size_t receive(Range &&buffer, std::span<double> timestamps = {})
+    {
+        using T = std::ranges::range_value_t<Range>;
+        if (this->mode != ModeTag::RECEIVER || var_tag_of<T>() != this->var)
+        {
+            std::cerr << "[WARNING] Stream " << this->name << " is not open for receiving " << this->dtype << ".\n";
+            return 0;
+        }
+        return this->receive_buffer(std::ranges::data(buffer), std::ranges::size(buffer), timestamps);
+    }
+
     /**
      * Sets the name of the streamer.
      * @param new_name New name to be set.
@@ -93,14 +239,39 @@ public:
     /**
      * Sets the data type of the stream.
      * @param dtype Data type to be set.
+     * @return True if the data type is known, false otherwise.
      */
-    void set_data_type(std::string dtype);
+    bool set_data_type(std::string dtype);
 
     /**
      * Sets the number of channels in the stream.
      * @param new_num_channels Number of channels to be set.
      */
     void set_num_channels(std::size_t new_num_channels);
+
+    /**
+     * Sets the nominal sampling rate of the stream.
+     * @param new_sampling_rate Samples per second per channel, 0 if irregular.
+     */
+    void set_sampling_rate(std::size_t new_sampling_rate);
+
+    /**
+     * Gets the data type of the stream.
+     * @return Data type tag.
+     */
+    [[nodiscard]] VarTag get_var_tag() const;
+
+    /**
+     * Gets the number of channels in the stream.
+     * @return Number of channels.
+     */
+    [[nodiscard]] std::size_t get_num_channels() const;
+
+    /**
+     * Gets the nominal sampling rate of the stream.
+     * @return Samples per second per channel, 0 if irregular.
+     */
+    [[nodiscard]] std::size_t get_sampling_rate() const;
 };
 
 #endif // HRI_PHYSIO_STREAMER_INTERFACE_H
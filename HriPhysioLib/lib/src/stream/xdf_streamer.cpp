@@ -0,0 +1,553 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Shrikar Nakhye,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Shrikar Nakhye <shrikar.nakhye@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+#include "xdf_streamer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+namespace
+{
+    //-- Chunk tags defined by the XDF specification.
+    constexpr std::uint16_t tag_file_header = 1;
+    constexpr std::uint16_t tag_stream_header = 2;
+    constexpr std::uint16_t tag_samples = 3;
+    constexpr std::uint16_t tag_clock_offset = 4;
+    constexpr std::uint16_t tag_stream_footer = 6;
+
+    constexpr char magic[4] = {'X', 'D', 'F', ':'};
+
+    //-- XDF channel formats, by VarTag.
+    const std::unordered_map<VarTag, std::string> var_tag_to_format = {
+        {VarTag::CHAR, "int8"},
+        {VarTag::INT16, "int16"},
+        {VarTag::INT32, "int32"},
+        {VarTag::INT64, "int64"},
+        {VarTag::FLOAT, "float32"},
+        {VarTag::DOUBLE, "double64"},
+        {VarTag::STRING, "string"},
+    };
+
+    template <typename T>
+    void append(std::vector<char> &out, const T &value)
+    {
+        const char *bytes = reinterpret_cast<const char *>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    //-- Variable-length integers are a byte count (1, 4 or 8) followed by the value.
+    void append_varlen(std::vector<char> &out, std::uint64_t value)
+    {
+        if (value <= 0xFF)
+        {
+            append(out, std::uint8_t{1});
+            append(out, static_cast<std::uint8_t>(value));
+        }
+        else if (value <= 0xFFFFFFFF)
+        {
+            append(out, std::uint8_t{4});
+            append(out, static_cast<std::uint32_t>(value));
+        }
+        else
+        {
+            append(out, std::uint8_t{8});
+            append(out, value);
+        }
+    }
+
+    //-- Fields in the mapping are not aligned, so read them by copy.
+    template <typename T>
+    T load(const char *bytes)
+    {
+        T value;
+        std::memcpy(&value, bytes, sizeof(T));
+        return value;
+    }
+
+    bool load_varlen(const char *&cursor, const char *end, std::uint64_t &value)
+    {
+        if (cursor >= end)
+        {
+            return false;
+        }
+
+        const auto num_bytes = static_cast<std::uint8_t>(*cursor);
+        if ((num_bytes != 1 && num_bytes != 4 && num_bytes != 8) || cursor + 1 + num_bytes > end)
+        {
+            return false;
+        }
+
+        value = 0;
+        std::memcpy(&value, cursor + 1, num_bytes);
+        cursor += 1 + num_bytes;
+        return true;
+    }
+
+    std::string escape_xml(const std::string &text)
+    {
+        std::string escaped;
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '&':
+                escaped += "&amp;";
+                break;
+            case '<':
+                escaped += "&lt;";
+                break;
+            case '>':
+                escaped += "&gt;";
+                break;
+            default:
+                escaped += c;
+            }
+        }
+        return escaped;
+    }
+
+    //-- Text of the first <tag> element; the top-level fields come before any <desc>.
+    std::string xml_value(const std::string &xml, const std::string &tag)
+    {
+        const std::string open = "<" + tag + ">";
+        const std::string close = "</" + tag + ">";
+        const std::size_t start = xml.find(open);
+        if (start == std::string::npos)
+        {
+            return "";
+        }
+        const std::size_t end = xml.find(close, start + open.size());
+        if (end == std::string::npos)
+        {
+            return "";
+        }
+
+        std::string value = xml.substr(start + open.size(), end - start - open.size());
+        for (auto [entity, character] : {std::pair{"&lt;", "<"}, {"&gt;", ">"}, {"&amp;", "&"}})
+        {
+            for (std::size_t at = value.find(entity); at != std::string::npos; at = value.find(entity, at + 1))
+            {
+                value.replace(at, std::strlen(entity), character);
+            }
+        }
+        return value;
+    }
+
+    std::string format_double(double value)
+    {
+        std::ostringstream text;
+        text.precision(17);
+        text << value;
+        return text.str();
+    }
+}
+
+XdfWriter::XdfWriter(const std::string &path) : next_stream_id(1)
+{
+    output.open(path, std::ios::binary | std::ios::trunc);
+    if (!output)
+    {
+        std::cerr << "[WARNING] Could not create " << path << ".\n";
+        return;
+    }
+
+    output.write(magic, sizeof(magic));
+
+    const std::string header = "<?xml version=\"1.0\"?><info><version>1.0</version></info>";
+    this->write_chunk(tag_file_header, std::vector<char>(header.begin(), header.end()));
+}
+
+bool XdfWriter::is_open()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return output.is_open() && static_cast<bool>(output);
+}
+
+std::uint32_t XdfWriter::add_stream()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return next_stream_id++;
+}
+
+bool XdfWriter::write_chunk(std::uint16_t tag, const std::vector<char> &content)
+{
+    //-- The length covers the tag and the content.
+    std::vector<char> prefix;
+    append_varlen(prefix, content.size() + sizeof(tag));
+    append(prefix, tag);
+
+    std::lock_guard<std::mutex> guard(lock);
+    output.write(prefix.data(), static_cast<std::streamsize>(prefix.size()));
+    output.write(content.data(), static_cast<std::streamsize>(content.size()));
+    return static_cast<bool>(output);
+}
+
+XDFStreamer::XDFStreamer() : StreamerInterface(),
+                             stream_id(0),
+                             first_timestamp(0.0),
+                             last_timestamp(0.0),
+                             sample_count(0),
+                             read_chunk(0),
+                             read_offset(0),
+                             read_sample(0),
+                             read_timestamp(0.0),
+                             read_rate(0.0) {}
+
+XDFStreamer::~XDFStreamer()
+{
+    if (this->mode == ModeTag::SENDER)
+    {
+        const std::string footer = "<?xml version=\"1.0\"?><info>"
+                                   "<first_timestamp>" + format_double(first_timestamp) + "</first_timestamp>"
+                                   "<last_timestamp>" + format_double(last_timestamp) + "</last_timestamp>"
+                                   "<sample_count>" + std::to_string(sample_count) + "</sample_count>"
+                                   "</info>";
+        this->begin_chunk();
+        chunk.insert(chunk.end(), footer.begin(), footer.end());
+        writer->write_chunk(tag_stream_footer, chunk);
+    }
+    else if (this->mode == ModeTag::RECEIVER)
+    {
+        input.close();
+    }
+}
+
+bool XDFStreamer::open_input_stream()
+{
+    if (this->mode != ModeTag::NOT_SET || !input.open(this->name))
+    {
+        return false;
+    }
+
+    const char *data = input.data();
+    const std::size_t size = input.size();
+    if (size < sizeof(magic) || std::memcmp(data, magic, sizeof(magic)) != 0)
+    {
+        std::cerr << "[WARNING] " << this->name << " is not an XDF file.\n";
+        input.close();
+        return false;
+    }
+
+    //-- One pass over the chunks finds the stream and its samples; the samples are read later.
+    std::uint32_t selected = 0;
+    std::string format;
+    const char *cursor = data + sizeof(magic);
+    const char *end = data + size;
+    std::uint64_t length = 0;
+    while (load_varlen(cursor, end, length))
+    {
+        if (length < sizeof(std::uint16_t) || static_cast<std::uint64_t>(end - cursor) < length)
+        {
+            break;
+        }
+
+        const auto tag = load<std::uint16_t>(cursor);
+        const char *content = cursor + sizeof(std::uint16_t);
+        const char *content_end = cursor + length;
+        cursor = content_end;
+
+        if (tag != tag_stream_header && tag != tag_samples && tag != tag_clock_offset)
+        {
+            continue;
+        }
+        if (content_end - content < static_cast<std::ptrdiff_t>(sizeof(std::uint32_t)))
+        {
+            continue;
+        }
+
+        const auto id = load<std::uint32_t>(content);
+        content += sizeof(std::uint32_t);
+
+        if (tag == tag_stream_header && selected == 0)
+        {
+            const std::string xml(content, content_end);
+            const std::string header_name = xml_value(xml, "name");
+            if (stream_name.empty() || header_name == stream_name)
+            {
+                selected = id;
+                stream_name = header_name;
+                format = xml_value(xml, "channel_format");
+                this->num_channels = std::strtoull(xml_value(xml, "channel_count").c_str(), nullptr, 10);
+                read_rate = std::strtod(xml_value(xml, "nominal_srate").c_str(), nullptr);
+                this->sampling_rate = static_cast<std::size_t>(read_rate);
+            }
+        }
+        else if (tag == tag_samples && id == selected && selected != 0)
+        {
+            std::uint64_t num_samples = 0;
+            if (load_varlen(content, content_end, num_samples))
+            {
+                sample_chunks.push_back({static_cast<std::size_t>(content - data),
+                                         static_cast<std::size_t>(content_end - data),
+                                         num_samples});
+            }
+        }
+        else if (tag == tag_clock_offset && id == selected && selected != 0 &&
+                 content_end - content >= static_cast<std::ptrdiff_t>(2 * sizeof(double)))
+        {
+            clock_offsets.push_back({load<double>(content), load<double>(content + sizeof(double))});
+        }
+    }
+
+    if (selected == 0)
+    {
+        std::cerr << "[WARNING] " << this->name << " has no stream named \"" << stream_name << "\".\n";
+        input.close();
+        return false;
+    }
+
+    auto candidate = std::find_if(var_tag_to_format.begin(), var_tag_to_format.end(),
+                                  [&](const auto &entry)
+                                  { return entry.second == format; });
+    if (candidate == var_tag_to_format.end() || candidate->first == VarTag::STRING)
+    {
+        std::cerr << "[WARNING] Unsupported channel format \"" << format << "\" in " << this->name << ".\n";
+        input.close();
+        return false;
+    }
+
+    this->set_var_tag(candidate->first);
+    if (!this->check_format())
+    {
+        input.close();
+        return false;
+    }
+
+    read_chunk = 0;
+    read_offset = sample_chunks.empty() ? 0 : sample_chunks.front().offset;
+    read_sample = 0;
+    read_timestamp = 0.0;
+
+    this->set_mode(ModeTag::RECEIVER);
+    return true;
+}
+
+bool XDFStreamer::open_output_stream()
+{
+    if (this->mode != ModeTag::NOT_SET || !this->check_format())
+    {
+        return false;
+    }
+
+    if (this->element_size() == 0)
+    {
+        std::cerr << "[WARNING] XDFStreamer records numeric samples, not " << this->dtype << ".\n";
+        return false;
+    }
+
+    if (!writer)
+    {
+        writer = std::make_shared<XdfWriter>(this->name);
+    }
+    if (!writer->is_open())
+    {
+        return false;
+    }
+
+    if (stream_name.empty())
+    {
+        stream_name = std::filesystem::path(this->name).stem().string();
+    }
+
+    stream_id = writer->add_stream();
+    const std::string xml = this->header_xml();
+    this->begin_chunk();
+    chunk.insert(chunk.end(), xml.begin(), xml.end());
+    if (!writer->write_chunk(tag_stream_header, chunk))
+    {
+        return false;
+    }
+
+    this->set_mode(ModeTag::SENDER);
+    return true;
+}
+
+void XDFStreamer::set_stream_name(std::string new_stream_name)
+{
+    this->stream_name = std::move(new_stream_name);
+}
+
+const std::string &XDFStreamer::get_stream_name() const
+{
+    return this->stream_name;
+}
+
+void XDFStreamer::set_stream_type(std::string new_stream_type)
+{
+    this->stream_type = std::move(new_stream_type);
+}
+
+void XDFStreamer::set_writer(std::shared_ptr<XdfWriter> shared_writer)
+{
+    this->writer = std::move(shared_writer);
+}
+
+std::shared_ptr<XdfWriter> XDFStreamer::get_writer() const
+{
+    return this->writer;
+}
+
+bool XDFStreamer::add_clock_offset(double collection_time, double offset)
+{
+    if (this->mode != ModeTag::SENDER)
+    {
+        return false;
+    }
+
+    this->begin_chunk();
+    append(chunk, collection_time);
+    append(chunk, offset);
+    return writer->write_chunk(tag_clock_offset, chunk);
+}
+
+const std::vector<XDFStreamer::ClockOffset> &XDFStreamer::get_clock_offsets() const
+{
+    return this->clock_offsets;
+}
+
+bool XDFStreamer::publish_buffer(const void *buffer, std::size_t num_elements, std::span<const double> timestamps)
+{
+    std::size_t num_frames = num_elements / this->num_channels;
+    if (!timestamps.empty())
+    {
+        num_frames = std::min(num_frames, timestamps.size());
+    }
+    if (num_frames == 0)
+    {
+        return true;
+    }
+
+    //-- Each sample is a timestamp byte count (0 or 8), the timestamp, then the channel values.
+    const std::size_t frame_bytes = this->num_channels * this->element_size();
+    const char *samples = static_cast<const char *>(buffer);
+
+    this->begin_chunk();
+    append_varlen(chunk, num_frames);
+    for (std::size_t frame = 0; frame < num_frames; ++frame)
+    {
+        if (timestamps.empty())
+        {
+            append(chunk, std::uint8_t{0});
+        }
+        else
+        {
+            append(chunk, std::uint8_t{8});
+            append(chunk, timestamps[frame]);
+        }
+        chunk.insert(chunk.end(), samples + frame * frame_bytes, samples + (frame + 1) * frame_bytes);
+    }
+
+    if (!timestamps.empty())
+    {
+        if (sample_count == 0)
+        {
+            first_timestamp = timestamps.front();
+        }
+        last_timestamp = timestamps[num_frames - 1];
+    }
+    sample_count += num_frames;
+
+    return writer->write_chunk(tag_samples, chunk);
+}
+
+std::size_t XDFStreamer::receive_buffer(void *buffer, std::size_t num_elements, std::span<double> timestamps)
+{
+    std::size_t num_frames = num_elements / this->num_channels;
+    if (!timestamps.empty())
+    {
+        num_frames = std::min(num_frames, timestamps.size());
+    }
+
+    const char *data = input.data();
+    const std::size_t frame_bytes = this->num_channels * this->element_size();
+    char *destination = static_cast<char *>(buffer);
+    std::size_t frames = 0;
+
+    while (frames < num_frames && read_chunk < sample_chunks.size())
+    {
+        const SampleChunk &current = sample_chunks[read_chunk];
+        if (read_sample >= current.num_samples)
+        {
+            ++read_chunk;
+            read_offset = (read_chunk < sample_chunks.size()) ? sample_chunks[read_chunk].offset : 0;
+            read_sample = 0;
+            continue;
+        }
+
+        //-- A chunk claiming more samples than it holds ends before the next timestamp byte.
+        if (read_offset >= current.end)
+        {
+            std::cerr << "[WARNING] Corrupt Samples chunk in " << this->name << ".\n";
+            read_sample = current.num_samples;
+            continue;
+        }
+
+        //-- Samples without a timestamp follow the previous one at the nominal rate.
+        const auto stamp_bytes = static_cast<std::uint8_t>(data[read_offset]);
+        double timestamp = read_timestamp + (read_rate > 0.0 ? 1.0 / read_rate : 0.0);
+        std::size_t offset = read_offset + 1;
+        if (stamp_bytes == sizeof(double) && offset + sizeof(double) <= current.end)
+        {
+            timestamp = load<double>(data + offset);
+            offset += sizeof(double);
+        }
+        else if (stamp_bytes != 0)
+        {
+            offset = current.end;
+        }
+
+        if (offset + frame_bytes > current.end)
+        {
+            std::cerr << "[WARNING] Corrupt Samples chunk in " << this->name << ".\n";
+            read_sample = current.num_samples;
+            continue;
+        }
+
+        std::memcpy(destination + frames * frame_bytes, data + offset, frame_bytes);
+        if (!timestamps.empty())
+        {
+            timestamps[frames] = timestamp;
+        }
+
+        read_offset = offset + frame_bytes;
+        read_timestamp = timestamp;
+        ++read_sample;
+        ++frames;
+    }
+
+    return frames * this->num_channels;
+}
+
+std::string XDFStreamer::header_xml() const
+{
+    const double created_at = std::chrono::duration<double>(
+                                  std::chrono::steady_clock::now().time_since_epoch())
+                                  .count();
+
+    return "<?xml version=\"1.0\"?><info>"
+           "<name>" + escape_xml(stream_name) + "</name>"
+           "<type>" + escape_xml(stream_type) + "</type>"
+           "<channel_count>" + std::to_string(this->num_channels) + "</channel_count>"
+           "<nominal_srate>" + std::to_string(this->sampling_rate) + "</nominal_srate>"
+           "<channel_format>" + var_tag_to_format.at(this->var) + "</channel_format>"
+           "<created_at>" + format_double(created_at) + "</created_at>"
+           "</info>";
+}
+
+void XDFStreamer::begin_chunk()
+{
+    chunk.clear();
+    append(chunk, stream_id);
+}
@@ -0,0 +1,278 @@
+/* ================================================================================
+ * Copyright: (C) 2024, Shrikar Nakhye,
+ *     Hochschule Bonn-Rhein-Sieg (H-BRS), All rights reserved.
+ *
+ * Author:
+ *     Shrikar Nakhye <shrikar.nakhye@smail.inf.h-brs.de>
+ *
+ * CopyPolicy: Released under the terms of the MIT License.
+ *     See the accompanying LICENSE file for details.
+ * ================================================================================
+ */
+#ifndef HRI_PHYSIO_XDF_STREAMER_H
+#define HRI_PHYSIO_XDF_STREAMER_H
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+#include "streamer_interface.h"
+
+/**
+ * @class XdfWriter
+ * @brief An XDF file shared by the streams recorded into it.
+ *
+ * Writes the magic code and file header on creation, then one chunk per
+ * call. Every chunk is assembled first and written with a single call under
+ * a mutex, so streamers on different threads can share the file.
+ */
+class XdfWriter
+{
+private:
+    /**
+     * Output file stream.
+     */
+    std::ofstream output;
+
+    /**
+     * Id handed to the next stream.
+     */
+    std::uint32_t next_stream_id;
+
+    /**
+     * Mutex guarding the file.
+     */
+    std::mutex lock;
+
+public:
+    /**
+     * Constructor to create the file and write its header.
+     * @param path Path of the file.
+     */
+    explicit XdfWriter(const std::string &path);
+
+    /**
+     * Checks whether the file was created.
+     * @return True if the file is open, false otherwise.
+     */
+    bool is_open();
+
+    /**
+     * Reserves an id for a new stream.
+     * @return Id of the stream.
+     */
+    std::uint32_t add_stream();
+
+    /**
+     * Writes one chunk.
+     * @param tag XDF chunk tag.
+     * @param content Content of the chunk, after the tag.
+     * @return True if the chunk was written, false otherwise.
+     */
+    bool write_chunk(std::uint16_t tag, const std::vector<char> &content);
+
+    // Disallow copy and assignment operators.
+    XdfWriter(const XdfWriter &) = delete;
+    XdfWriter &operator=(const XdfWriter &) = delete;
+};
+
+/**
+ * @class XDFStreamer
+ * @brief Records a stream into an XDF file, or plays one back from it.
+ *
+ * Writing produces a StreamHeader chunk on open, one Samples chunk per
+ * publish(), ClockOffset chunks from add_clock_offset(), and a StreamFooter
+ * on destruction. Several streamers record into one file by sharing its
+ * writer through set_writer()/get_writer().
+ * Reading selects the stream named by set_stream_name(), or the first one,
+ * and delivers its samples in order. Samples stored without a timestamp get
+ * the previous one plus 1 / nominal rate, as pyxdf does. String streams are
+ * not supported.
+ */
+class XDFStreamer : public StreamerInterface
+{
+public:
+    /**
+     * @struct ClockOffset
+     * @brief Offset between the sender's and the recorder's clock at a time.
+     */
+    struct ClockOffset
+    {
+        double collection_time;
+        double offset;
+    };
+
+private:
+    /**
+     * File the stream is written to, possibly shared with other streams.
+     */
+    std::shared_ptr<XdfWriter> writer;
+
+    /**
+     * Id of the stream in the file.
+     */
+    std::uint32_t stream_id;
+
+    /**
+     * Name and content type of the stream in the XDF header.
+     */
+    std::string stream_name;
+    std::string stream_type;
+
+    /**
+     * First and last timestamp, and number of samples written, for the footer.
+     */
+    double first_timestamp;
+    double last_timestamp;
+    std::uint64_t sample_count;
+
+    /**
+     * Reusable buffer the next chunk is assembled in.
+     */
+    std::vector<char> chunk;
+
+    /**
+     * Input file, mapped read-only.
+     */
+    MappedFile input;
+
+    /**
+     * @struct SampleChunk
+     * @brief A Samples chunk of the selected stream in the input file.
+     */
+    struct SampleChunk
+    {
+        std::size_t offset;
+        std::size_t end;
+        std::uint64_t num_samples;
+    };
+
+    /**
+     * Samples chunks of the selected stream, in file order.
+     */
+    std::vector<SampleChunk> sample_chunks;
+
+    /**
+     * Clock offsets of the selected stream.
+     */
+    std::vector<ClockOffset> clock_offsets;
+
+    /**
+     * Chunk being read, offset of its next sample, and samples of it already read.
+     */
+    std::size_t read_chunk;
+    std::size_t read_offset;
+    std::uint64_t read_sample;
+
+    /**
+     * Timestamp of the last sample read, and the nominal rate, to deduce missing ones.
+     */
+    double read_timestamp;
+    double read_rate;
+
+public:
+    /**
+     * Constructor to initialize the XDFStreamer.
+     */
+    XDFStreamer();
+
+    /**
+     * Destructor writes the stream footer when recording.
+     */
+    ~XDFStreamer();
+
+    /**
+     * Opens an XDF file and selects a stream in it. The data type, channel
+     * count and rate are taken from the stream's header.
+     * @return True if the stream was found, false otherwise.
+     */
+    bool open_input_stream() override;
+
+    /**
+     * Adds the stream to the shared writer, or creates the file, and writes the stream header.
+     * @return True if the header was written, false otherwise.
+     */
+    bool open_output_stream() override;
+
+    /**
+     * Sets the stream name, written to or looked up in the file; the file's stem by default.
+     * @param new_stream_name Name of the stream.
+     */
+    void set_stream_name(std::string new_stream_name);
+
+    /**
+     * Gets the name of the stream.
+     * @return Name of the stream.
+     */
+    [[nodiscard]] const std::string &get_stream_name() const;
+
+    /**
+     * Sets the content type written to the stream header, e.g. "ECG".
+     * @param new_stream_type Content type of the stream.
+     */
+    void set_stream_type(std::string new_stream_type);
+
+    /**
+     * Records into the file of another streamer instead of creating one.
+     * Must be called before open_output_stream().
+     * @param shared_writer Writer of the file.
+     */
+    void set_writer(std::shared_ptr<XdfWriter> shared_writer);
+
+    /**
+     * Gets the writer of the file this stream records into.
+     * @return Writer of the file, empty before open_output_stream().
+     */
+    [[nodiscard]] std::shared_ptr<XdfWriter> get_writer() const;
+
+    /**
+     * Records the offset between the sender's clock and the local one, e.g.
+     * from lsl::stream_inlet::time_correction().
+     * @param collection_time Local time the offset was measured at.
+     * @param offset Offset in seconds.
+     * @return True if the chunk was written, false otherwise.
+     */
+    bool add_clock_offset(double collection_time, double offset);
+
+    /**
+     * Gets the clock offsets recorded for the stream being read.
+     * @return Clock offsets in file order.
+     */
+    [[nodiscard]] const std::vector<ClockOffset> &get_clock_offsets() const;
+
+protected:
+    /**
+     * Writes the samples as one Samples chunk.
+     * @param buffer Elements of the stream's data type.
+     * @param num_elements Number of elements in the buffer.
+     * @param timestamps One timestamp per frame, or empty.
+     * @return True if the chunk was written, false otherwise.
+     */
+    bool publish_buffer(const void *buffer, std::size_t num_elements, std::span<const double> timestamps) override;
+
+    /**
+     * Copies samples of the selected stream, continuing mid-chunk where the last call stopped.
+     * @param buffer Destination for elements of the stream's data type.
+     * @param num_elements Capacity of the destination in elements.
+     * @param timestamps Destination for one timestamp per frame, or empty.
+     * @return Number of elements written, 0 at the end of the stream.
+     */
+    std::size_t receive_buffer(void *buffer, std::size_t num_elements, std::span<double> timestamps) override;
+
+private:
+    /**
+     * Assembles the stream header XML.
+     * @return XML describing the stream.
+     */
+    [[nodiscard]] std::string header_xml() const;
+
+    /**
+     * Starts a chunk for this stream: clears the buffer and appends the stream id.
+     */
+    void begin_chunk();
+};
+
+#endif // HRI_PHYSIO_XDF_STREAMER_H
@@ -43,4 +43,24 @@ enum VarTag
     STRING
 };
 
+/**
+ * What a loop thread does when an iteration runs past its next deadline.
+ */
+enum class OverrunPolicy
+{
+    SKIP,     // Drop the missed iterations and resume on the next deadline.
+    CATCH_UP, // Run the missed iterations back-to-back until on schedule again.
+    WARN      // Like SKIP, but report the overrun on std::cerr.
+};
+
+/**
+ * OS scheduling policy requested for a managed thread.
+ */
+enum class SchedulingPolicy
+{
+    DEFAULT,    // Leave the thread under the normal time-sharing scheduler.
+    FIFO,       // SCHED_FIFO real-time scheduling.
+    ROUND_ROBIN // SCHED_RR real-time scheduling.
+};
+
 #endif // HRI_PHYSIO_ENUMS_H
@@ -0,0 +1,134 @@
+/* ================================================================================
+ * Throughput benchmark for reading recorded CSV files: the getline /
+ * stringstream / std::stod loop the CLI used against CSVStreamer's
+ * memory-mapped from_chars reader.
+ *
+ * The file is generated with CSVStreamer in the logger's own format, a
+ * wall-clock prefix, a timestamp and 8 double channels per row. Pass the
+ * file size in MB as the first argument (default 1024).
+ * ================================================================================
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../src/stream/csv_streamer.h"
+
+namespace
+{
+    constexpr std::size_t num_channels = 8;
+    constexpr std::size_t chunk_frames = 4096;
+
+    void generate(const std::filesystem::path &path, std::uintmax_t size)
+    {
+        CSVStreamer csv;
+        csv.set_name(path.string());
+        csv.set_data_type("double");
+        csv.set_num_channels(num_channels);
+        csv.set_write_buffer(1 << 22);
+        csv.open_output_stream();
+
+        std::vector<double> frames(chunk_frames * num_channels);
+        std::vector<double> timestamps(chunk_frames);
+        std::size_t row = 0;
+        while (std::filesystem::file_size(path) < size)
+        {
+            for (std::size_t i = 0; i < chunk_frames; ++i, ++row)
+            {
+                timestamps[i] = static_cast<double>(row) / 130.0;
+                for (std::size_t ch = 0; ch < num_channels; ++ch)
+                {
+                    frames[i * num_channels + ch] = std::sin(0.01 * static_cast<double>(row + ch)) * 1000.0;
+                }
+            }
+            csv.publish(frames, timestamps);
+            csv.flush();
+        }
+    }
+
+    double run_getline(const std::filesystem::path &path, double &checksum)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        std::ifstream input(path);
+        std::string line;
+        while (std::getline(input, line))
+        {
+            std::stringstream ss(line);
+            std::string value;
+            std::getline(ss, value, ',');
+            while (std::getline(ss, value, ','))
+            {
+                checksum += std::stod(value);
+            }
+        }
+
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    double run_streamer(const std::filesystem::path &path, double &checksum)
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        CSVStreamer csv;
+        csv.set_name(path.string());
+        csv.set_data_type("double");
+        csv.set_num_channels(num_channels);
+        csv.open_input_stream();
+
+        std::vector<double> frames(chunk_frames * num_channels);
+        std::vector<double> timestamps(chunk_frames);
+        std::size_t received;
+        while ((received = csv.receive(frames, timestamps)) != 0)
+        {
+            for (std::size_t i = 0; i < received / num_channels; ++i)
+            {
+                checksum += timestamps[i];
+            }
+            for (std::size_t i = 0; i < received; ++i)
+            {
+                checksum += frames[i];
+            }
+        }
+
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const std::uintmax_t megabytes = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1024;
+    const auto path = std::filesystem::temp_directory_path() / "hri_physio_csv_reader_benchmark.csv";
+
+    generate(path, megabytes << 20);
+    const double size_mb = static_cast<double>(std::filesystem::file_size(path)) / (1 << 20);
+    std::cout << std::fixed << std::setprecision(0) << size_mb << " MB, " << num_channels << " double channels\n";
+    std::cout << std::left << std::setw(28) << "reader" << "MB/s\n";
+
+    double legacy_sum = 0.0;
+    const double legacy = size_mb / run_getline(path, legacy_sum);
+    std::cout << std::setw(28) << "getline + stringstream" << legacy << "\n";
+
+    double mapped_sum = 0.0;
+    const double mapped = size_mb / run_streamer(path, mapped_sum);
+    std::cout << std::setw(28) << "CSVStreamer, mmap" << mapped
+              << "  (" << std::setprecision(1) << mapped / legacy << "x)\n";
+
+    //-- Both readers must see the same numbers.
+    if (std::abs(legacy_sum - mapped_sum) > 1e-6 * std::abs(legacy_sum))
+    {
+        std::cerr << "Checksums differ: " << legacy_sum << " vs " << mapped_sum << "\n";
+        std::filesystem::remove(path);
+        return 1;
+    }
+
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,101 @@
+/* ================================================================================
+ * Throughput benchmark for CSV logging: the previous iostream writer
+ * (put_time, operator<< and std::endl per row) against CSVStreamer flushing
+ * after every publish and CSVStreamer in buffered mode.
+ *
+ * Rows carry a timestamp and 8 double channels, published one frame at a
+ * time as a 130 Hz receiver would.
+ * ================================================================================
+ */
+
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "../src/stream/csv_streamer.h"
+
+namespace
+{
+    constexpr std::size_t num_channels = 8;
+    constexpr std::size_t num_rows = 200000;
+
+    std::vector<double> make_samples()
+    {
+        std::vector<double> samples(num_rows * num_channels);
+        for (std::size_t i = 0; i < samples.size(); ++i)
+        {
+            samples[i] = std::sin(0.001 * static_cast<double>(i)) * 1000.0;
+        }
+        return samples;
+    }
+
+    double run_iostream(const std::filesystem::path &path, const std::vector<double> &samples)
+    {
+        std::ofstream output(path);
+        auto start = std::chrono::steady_clock::now();
+
+        for (std::size_t row = 0; row < num_rows; ++row)
+        {
+            std::time_t time = std::time(nullptr);
+            output << std::put_time(std::localtime(&time), "%Y/%m/%d_%H:%M:%S") << ",";
+            output << std::setprecision(10) << static_cast<double>(row) / 130.0;
+            for (std::size_t ch = 0; ch < num_channels; ++ch)
+            {
+                output << "," << samples[row * num_channels + ch];
+            }
+            output << std::endl;
+        }
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(num_rows) / elapsed.count();
+    }
+
+    double run_streamer(const std::filesystem::path &path, const std::vector<double> &samples, std::size_t buffer)
+    {
+        auto start = std::chrono::steady_clock::now();
+        {
+            CSVStreamer csv;
+            csv.set_name(path.string());
+            csv.set_data_type("double");
+            csv.set_num_channels(num_channels);
+            csv.set_write_buffer(buffer);
+            csv.open_output_stream();
+
+            for (std::size_t row = 0; row < num_rows; ++row)
+            {
+                const double timestamp = static_cast<double>(row) / 130.0;
+                csv.publish(std::span<const double>(samples.data() + row * num_channels, num_channels),
+                            std::span<const double>(&timestamp, 1));
+            }
+        }
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(num_rows) / elapsed.count();
+    }
+}
+
+int main()
+{
+    const auto path = std::filesystem::temp_directory_path() / "hri_physio_csv_writer_benchmark.csv";
+    const std::vector<double> samples = make_samples();
+
+    std::cout << num_rows << " rows of " << num_channels << " double channels\n";
+    std::cout << std::left << std::setw(28) << "writer" << "rows/s\n";
+
+    const double legacy = run_iostream(path, samples);
+    std::cout << std::setw(28) << "iostream + endl" << std::fixed << std::setprecision(0) << legacy << "\n";
+
+    const double per_publish = run_streamer(path, samples, 0);
+    std::cout << std::setw(28) << "CSVStreamer, flush/publish" << per_publish << "\n";
+
+    const double buffered = run_streamer(path, samples, 1 << 20);
+    std::cout << std::setw(28) << "CSVStreamer, 1 MiB buffer" << buffered
+              << "  (" << std::setprecision(1) << buffered / legacy << "x)\n";
+
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,129 @@
+/* ================================================================================
+ * Contention benchmark for several producers feeding one consumer, comparing
+ * the mutex-guarded RingBuffer against the lock-free MpmcRingBuffer.
+ *
+ * Every producer pushes fixed-size chunks, as one LSL inlet per device would.
+ * Producers never run more than half a buffer ahead of the consumer, so
+ * neither buffer drops or rejects data and both move the same number of items.
+ * ================================================================================
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "../src/core/mpmc_ring_buffer.h"
+#include "../src/core/ring_buffer.h"
+
+namespace
+{
+    constexpr std::size_t buffer_length = 8192;
+    constexpr std::size_t chunk = 32;
+    constexpr std::size_t num_items = 1 << 21;
+
+    struct Result
+    {
+        double rate;
+        double chunk_latency_us;
+    };
+
+    template <class Buffer>
+    Result run(Buffer &rb, const std::size_t num_producers)
+    {
+        std::atomic<std::size_t> produced{0};
+        std::atomic<std::size_t> consumed{0};
+        std::atomic<std::int64_t> enqueue_ns{0};
+        const std::size_t per_producer = num_items / num_producers / chunk * chunk;
+        const std::size_t total = per_producer * num_producers;
+
+        auto start = std::chrono::steady_clock::now();
+
+        std::vector<std::thread> producers;
+        for (std::size_t id = 0; id < num_producers; ++id)
+        {
+            producers.emplace_back([&] {
+                std::vector<double> items(chunk, 1.0);
+                std::int64_t local_ns = 0;
+                for (std::size_t sent = 0; sent < per_producer;)
+                {
+                    if (produced.load(std::memory_order_relaxed) - consumed.load(std::memory_order_acquire) + chunk >
+                        buffer_length / 2)
+                    {
+                        std::this_thread::yield();
+                        continue;
+                    }
+
+                    auto before = std::chrono::steady_clock::now();
+                    bool ok = rb.enqueue(items.data(), chunk);
+                    local_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now() - before)
+                                    .count();
+
+                    if (ok)
+                    {
+                        sent += chunk;
+                        produced.fetch_add(chunk, std::memory_order_relaxed);
+                    }
+                }
+                enqueue_ns.fetch_add(local_ns, std::memory_order_relaxed);
+            });
+        }
+
+        std::vector<double> items(chunk);
+        std::size_t received = 0;
+        while (received < total)
+        {
+            if (!rb.dequeue(items.data(), chunk))
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            received += chunk;
+            consumed.store(received, std::memory_order_release);
+        }
+
+        for (auto &producer : producers)
+        {
+            producer.join();
+        }
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return {static_cast<double>(total) / elapsed.count() / 1e6,
+                static_cast<double>(enqueue_ns.load()) / static_cast<double>(total / chunk) / 1e3};
+    }
+}
+
+int main()
+{
+    std::cout << "Multi-producer throughput, " << num_items << " doubles in chunks of " << chunk
+              << ", 1 consumer" << std::endl;
+    std::cout << std::setw(10) << "producers"
+              << std::setw(14) << "mutex [M/s]"
+              << std::setw(16) << "mutex push [us]"
+              << std::setw(14) << "mpmc [M/s]"
+              << std::setw(15) << "mpmc push [us]"
+              << std::setw(16) << "mpmc CAS fails" << std::endl;
+
+    for (std::size_t num_producers : {1, 2, 4, 8})
+    {
+        RingBuffer<double> locked(buffer_length);
+        MpmcRingBuffer<double> lock_free(buffer_length);
+
+        Result locked_result = run(locked, num_producers);
+        Result lock_free_result = run(lock_free, num_producers);
+
+        std::cout << std::setw(10) << num_producers
+                  << std::fixed << std::setprecision(2)
+                  << std::setw(14) << locked_result.rate
+                  << std::setw(16) << locked_result.chunk_latency_us
+                  << std::setw(14) << lock_free_result.rate
+                  << std::setw(15) << lock_free_result.chunk_latency_us
+                  << std::setw(16) << lock_free.contention() << std::endl;
+    }
+
+    return 0;
+}
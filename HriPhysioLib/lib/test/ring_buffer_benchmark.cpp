@@ -0,0 +1,94 @@
+/* ================================================================================
+ * Throughput benchmark for the mutex-guarded RingBuffer against the
+ * lock-free SpscRingBuffer, with one producer and one consumer thread.
+ *
+ * The producer never runs more than half a buffer ahead of the consumer, so
+ * neither buffer drops or rejects data and both move the same number of items.
+ * ================================================================================
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "../src/core/ring_buffer.h"
+#include "../src/core/spsc_ring_buffer.h"
+
+namespace
+{
+    constexpr std::size_t buffer_length = 4096;
+    constexpr std::size_t num_items = 1 << 22;
+
+    template <class Buffer>
+    double run(Buffer &rb, const std::size_t chunk)
+    {
+        std::atomic<std::size_t> consumed{0};
+
+        auto start = std::chrono::steady_clock::now();
+
+        std::thread producer([&] {
+            std::vector<double> items(chunk, 1.0);
+            std::size_t produced = 0;
+            while (produced < num_items)
+            {
+                if (produced - consumed.load(std::memory_order_acquire) + chunk > buffer_length / 2)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                bool ok = (chunk == 1) ? rb.enqueue(items[0]) : rb.enqueue(items.data(), chunk);
+                if (ok)
+                {
+                    produced += chunk;
+                }
+            }
+        });
+
+        std::vector<double> items(chunk);
+        std::size_t total = 0;
+        while (total < num_items)
+        {
+            bool ok = (chunk == 1) ? rb.dequeue(items[0]) : rb.dequeue(items.data(), chunk);
+            if (!ok)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            total += chunk;
+            consumed.store(total, std::memory_order_release);
+        }
+
+        producer.join();
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(num_items) / elapsed.count() / 1e6;
+    }
+}
+
+int main()
+{
+    std::cout << "RingBuffer throughput, " << num_items << " doubles, 1 producer / 1 consumer" << std::endl;
+    std::cout << std::setw(8) << "chunk"
+              << std::setw(18) << "mutex [M/s]"
+              << std::setw(18) << "spsc [M/s]" << std::endl;
+
+    for (std::size_t chunk : {1, 8, 64, 256})
+    {
+        RingBuffer<double> locked(buffer_length);
+        SpscRingBuffer<double> lock_free(buffer_length);
+
+        double locked_rate = run(locked, chunk);
+        double lock_free_rate = run(lock_free, chunk);
+
+        std::cout << std::setw(8) << chunk
+                  << std::setw(18) << std::fixed << std::setprecision(2) << locked_rate
+                  << std::setw(18) << lock_free_rate << std::endl;
+    }
+
+    return 0;
+}
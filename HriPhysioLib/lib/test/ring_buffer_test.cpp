@@ -0,0 +1,515 @@
+#include <gtest/gtest.h>
+#include "../src/core/ring_buffer.h"
+#include "../src/core/frame_ring_buffer.h"
+#include "../src/core/mirrored_ring_buffer.h"
+#include "../src/core/mpmc_ring_buffer.h"
+#include "../src/core/sliding_window.h"
+#include "../src/core/spsc_ring_buffer.h"
+#include "../src/core/timestamped_ring_buffer.h"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+class RingBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+};
+
+TEST_F(RingBufferTest, InitializeBuffer) {
+    RingBuffer<int> rb(3);
+
+    EXPECT_EQ(rb.length(), 3u);
+    EXPECT_EQ(rb.size(), 0u);
+    EXPECT_TRUE(rb.empty());
+}
+
+TEST_F(RingBufferTest, PushAndPop) {
+    RingBuffer<int> rb(3);
+    int out;
+
+    rb.enqueue(5);
+    rb.enqueue(3);
+    EXPECT_EQ(rb.size(), 2u);
+
+    ASSERT_TRUE(rb.dequeue(out));
+    EXPECT_EQ(out, 5);
+    ASSERT_TRUE(rb.dequeue(out));
+    EXPECT_EQ(out, 3);
+    EXPECT_FALSE(rb.dequeue(out));
+}
+
+TEST_F(RingBufferTest, OverflowHandling) {
+    RingBuffer<int> rb(3);
+    int out;
+
+    rb.enqueue(3);
+    rb.enqueue(9);
+    rb.enqueue(13);
+    rb.enqueue(22); // overwrites 3.
+    EXPECT_EQ(rb.size(), 3u);
+
+    ASSERT_TRUE(rb.dequeue(out));
+    EXPECT_EQ(out, 9);
+}
+
+TEST_F(RingBufferTest, BulkTransferAcrossWrap) {
+    RingBuffer<double> rb(5);
+    const double first[] = {1.0, 2.0, 3.0};
+    const double second[] = {4.0, 5.0, 6.0};
+    double out[4];
+
+    ASSERT_TRUE(rb.enqueue(first, 3));
+    ASSERT_TRUE(rb.dequeue(out, 2));
+    ASSERT_TRUE(rb.enqueue(second, 3)); // tail wraps around the end.
+    EXPECT_EQ(rb.size(), 4u);
+
+    ASSERT_TRUE(rb.front(out, 4));
+    EXPECT_EQ(out[0], 3.0);
+    EXPECT_EQ(out[3], 6.0);
+
+    ASSERT_TRUE(rb.dequeue(out, 4, 1));
+    EXPECT_EQ(out[1], 4.0);
+    EXPECT_EQ(out[2], 5.0);
+    EXPECT_EQ(rb.size(), 1u);
+}
+
+TEST_F(RingBufferTest, BulkEnqueueOverwritesOnlyWhatItMust) {
+    RingBuffer<int> rb(4);
+    const int first[] = {1, 2};
+    const int second[] = {3, 4};
+    const int third[] = {5, 6, 7};
+    int out[4];
+
+    ASSERT_TRUE(rb.enqueue(first, 2));
+    ASSERT_TRUE(rb.enqueue(second, 2)); // exactly fills the buffer.
+    EXPECT_EQ(rb.size(), 4u);
+
+    ASSERT_TRUE(rb.enqueue(third, 3)); // overwrites 1, 2 and 3.
+    EXPECT_EQ(rb.size(), 4u);
+
+    ASSERT_TRUE(rb.dequeue(out, 4));
+    EXPECT_EQ(out[0], 4);
+    EXPECT_EQ(out[1], 5);
+    EXPECT_EQ(out[3], 7);
+}
+
+TEST_F(RingBufferTest, PeekViewsWrappedRegionWithoutCopy) {
+    RingBuffer<double> rb(4);
+    const double input[] = {1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+
+    ASSERT_TRUE(rb.enqueue(input, 4));
+    ASSERT_TRUE(rb.enqueue(input + 4, 2)); // holds 3, 4, 5, 6 with the tail wrapped.
+
+    {
+        auto view = rb.peek();
+        EXPECT_EQ(view.size(), 4u);
+        EXPECT_EQ(view.first.size(), 2u);
+        EXPECT_EQ(view.second.size(), 2u);
+        EXPECT_EQ(view[0], 3.0);
+        EXPECT_EQ(view[3], 6.0);
+        EXPECT_EQ(view.first.data(), rb.data() + 2);
+
+        ASSERT_TRUE(view.consume(3));
+        EXPECT_EQ(view.size(), 1u);
+        EXPECT_EQ(view[0], 6.0);
+    }
+
+    EXPECT_EQ(rb.size(), 1u);
+    EXPECT_TRUE(rb.consume(1));
+    EXPECT_FALSE(rb.consume(1));
+    EXPECT_TRUE(rb.peek().empty());
+}
+
+TEST_F(RingBufferTest, WaitDequeueWakesWhenFrameIsComplete) {
+    RingBuffer<int> rb(16);
+    const int input[] = {1, 2, 3, 4};
+    int out[4];
+
+    std::thread producer([&rb, &input] {
+        for (int idx = 0; idx < 4; ++idx) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            rb.enqueue(input[idx]);
+        }
+    });
+
+    ASSERT_TRUE(rb.wait_dequeue(out, 4, 1, 5.0));
+    EXPECT_EQ(out[0], 1);
+    EXPECT_EQ(out[3], 4);
+    EXPECT_EQ(rb.size(), 1u);
+
+    producer.join();
+}
+
+TEST_F(RingBufferTest, WaitDequeueTimesOut) {
+    RingBuffer<int> rb(16);
+    int out[4];
+
+    rb.enqueue(1);
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(rb.wait_dequeue(out, 4, 0, 0.05));
+    std::chrono::duration<double> waited = std::chrono::steady_clock::now() - start;
+
+    EXPECT_GE(waited.count(), 0.05);
+    EXPECT_EQ(rb.size(), 1u);
+}
+
+TEST_F(RingBufferTest, StatsCountDropsUnderrunsAndHighWaterMark) {
+    RingBuffer<int> rb(4);
+    const int input[] = {1, 2, 3, 4, 5, 6};
+    int out[4];
+
+    rb.enable_stats(true);
+    rb.enqueue(input, 3);
+    rb.enqueue(input + 3, 3); // overwrites 1 and 2.
+    ASSERT_TRUE(rb.dequeue(out, 3, 1));
+    EXPECT_FALSE(rb.dequeue(out, 4));
+
+    RingBufferStats stats = rb.stats();
+    EXPECT_EQ(stats.enqueued, 6u);
+    EXPECT_EQ(stats.dropped, 2u);
+    EXPECT_EQ(stats.dequeued, 2u);
+    EXPECT_EQ(stats.failed_dequeues, 1u);
+    EXPECT_EQ(stats.high_water_mark, 4u);
+
+    rb.reset_stats();
+    EXPECT_EQ(rb.stats().enqueued, 0u);
+}
+
+class SpscRingBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+};
+
+TEST_F(SpscRingBufferTest, LengthRoundsUpToPowerOfTwo) {
+    SpscRingBuffer<int> rb(5);
+
+    EXPECT_EQ(rb.length(), 8u);
+    EXPECT_TRUE(rb.empty());
+}
+
+TEST_F(SpscRingBufferTest, RejectsWhenFull) {
+    SpscRingBuffer<int> rb(4);
+    int out;
+
+    for (int idx = 0; idx < 4; ++idx) {
+        EXPECT_TRUE(rb.enqueue(idx));
+    }
+    EXPECT_TRUE(rb.full());
+    EXPECT_FALSE(rb.enqueue(99));
+
+    ASSERT_TRUE(rb.dequeue(out));
+    EXPECT_EQ(out, 0);
+    EXPECT_TRUE(rb.enqueue(4));
+}
+
+TEST_F(SpscRingBufferTest, DequeueWithOverlap) {
+    SpscRingBuffer<int> rb(8);
+    const int input[] = {1, 2, 3, 4, 5, 6};
+    int window[4];
+
+    ASSERT_TRUE(rb.enqueue(input, 6));
+    ASSERT_TRUE(rb.dequeue(window, 4, 2));
+    EXPECT_EQ(window[0], 1);
+    EXPECT_EQ(window[3], 4);
+    EXPECT_EQ(rb.size(), 4u);
+
+    ASSERT_TRUE(rb.dequeue(window, 4, 2));
+    EXPECT_EQ(window[0], 3);
+    EXPECT_EQ(window[3], 6);
+    EXPECT_FALSE(rb.dequeue(window, 4, 2));
+}
+
+TEST_F(SpscRingBufferTest, PeekAndConsume) {
+    SpscRingBuffer<int> rb(4);
+    const int input[] = {1, 2, 3};
+
+    ASSERT_TRUE(rb.enqueue(input, 3));
+    ASSERT_TRUE(rb.consume(2));
+    ASSERT_TRUE(rb.enqueue(input, 3)); // wraps.
+
+    RingSpan<int> view = rb.peek();
+    ASSERT_EQ(view.size(), 4u);
+    EXPECT_EQ(view.first.size(), 2u);
+    EXPECT_EQ(view[0], 3);
+    EXPECT_EQ(view[1], 1);
+    EXPECT_EQ(view[3], 3);
+
+    EXPECT_TRUE(rb.consume(4));
+    EXPECT_FALSE(rb.consume(1));
+    EXPECT_TRUE(rb.empty());
+}
+
+TEST_F(SpscRingBufferTest, ProducerConsumerPreservesOrder) {
+    const int num_items = 100000;
+    SpscRingBuffer<int> rb(64);
+
+    std::thread producer([&rb] {
+        for (int idx = 0; idx < num_items; ++idx) {
+            while (!rb.enqueue(idx)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    int out;
+    while (expected < num_items) {
+        if (!rb.dequeue(out)) {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_EQ(out, expected);
+        ++expected;
+    }
+
+    producer.join();
+    EXPECT_TRUE(rb.empty());
+}
+
+class TimestampedRingBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // Heart rate at 1 Hz, with the buffer wrapped once.
+        for (int idx = 0; idx < 12; ++idx) {
+            rb.enqueue(60.0 + idx, static_cast<double>(idx));
+        }
+    }
+
+    TimestampedRingBuffer<double> rb{10};
+};
+
+TEST_F(TimestampedRingBufferTest, RejectsTimestampsGoingBackwards) {
+    EXPECT_FALSE(rb.enqueue(0.0, 5.0));
+    EXPECT_TRUE(rb.enqueue(0.0, 11.0));
+    EXPECT_EQ(rb.size(), 10u);
+}
+
+TEST_F(TimestampedRingBufferTest, RangeQuery) {
+    std::vector<double> items;
+    std::vector<double> stamps;
+
+    ASSERT_EQ(rb.range(4.0, 6.5, items, &stamps), 3u);
+    EXPECT_EQ(items[0], 64.0);
+    EXPECT_EQ(items[2], 66.0);
+    EXPECT_EQ(stamps[2], 6.0);
+
+    EXPECT_EQ(rb.range(0.0, 1.5, items), 0u); // already overwritten.
+    EXPECT_TRUE(items.empty());
+}
+
+TEST_F(TimestampedRingBufferTest, LastSeconds) {
+    std::vector<double> items;
+
+    ASSERT_EQ(rb.last(3.0, items), 4u);
+    EXPECT_EQ(items.front(), 68.0);
+    EXPECT_EQ(items.back(), 71.0);
+
+    ASSERT_EQ(rb.last(100.0, items), 10u);
+    EXPECT_EQ(items.front(), 62.0);
+}
+
+TEST_F(TimestampedRingBufferTest, DiscardBefore) {
+    double stamp;
+
+    EXPECT_EQ(rb.discard_before(7.0), 5u);
+    ASSERT_TRUE(rb.oldest(stamp));
+    EXPECT_EQ(stamp, 7.0);
+    ASSERT_TRUE(rb.newest(stamp));
+    EXPECT_EQ(stamp, 11.0);
+}
+
+class FrameRingBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+};
+
+TEST_F(FrameRingBufferTest, InterleavedRoundTrip) {
+    FrameRingBuffer<int> rb(3, 4);
+    const int acc[] = {1, 10, 100, 2, 20, 200, 3, 30, 300};
+    int out[6];
+
+    ASSERT_TRUE(rb.enqueue(acc, 3));
+    EXPECT_EQ(rb.size(), 3u);
+
+    ASSERT_TRUE(rb.dequeue(out, 2, 1));
+    EXPECT_EQ(out[0], 1);
+    EXPECT_EQ(out[2], 100);
+    EXPECT_EQ(out[5], 200);
+    EXPECT_EQ(rb.size(), 2u);
+}
+
+TEST_F(FrameRingBufferTest, PlanarReadOutAcrossWrap) {
+    FrameRingBuffer<int> rb(2, 3);
+    const int first[] = {1, -1, 2, -2};
+    const int second[] = {3, -3, 4, -4};
+    int out[6];
+
+    ASSERT_TRUE(rb.enqueue(first, 2));
+    ASSERT_TRUE(rb.enqueue(second, 2)); // overwrites frame 1.
+
+    {
+        auto view = rb.peek();
+        ASSERT_EQ(view.size(), 3u);
+        RingSpan<int> y = view.channel(1);
+        EXPECT_EQ(y[0], -2);
+        EXPECT_EQ(y[2], -4);
+    }
+
+    ASSERT_TRUE(rb.dequeue_planar(out, 3));
+    EXPECT_EQ(out[0], 2);
+    EXPECT_EQ(out[2], 4);
+    EXPECT_EQ(out[3], -2);
+    EXPECT_EQ(out[5], -4);
+    EXPECT_TRUE(rb.empty());
+}
+
+class MirroredRingBufferTest : public ::testing::Test {
+protected:
+    // Fill past the end so the newest window straddles the wrap point.
+    static void ExpectContiguousWindow(MirroredRingBuffer<double> &rb) {
+        const std::size_t length = rb.length();
+        std::vector<double> input(length + length / 2);
+        for (std::size_t idx = 0; idx < input.size(); ++idx) {
+            input[idx] = static_cast<double>(idx);
+        }
+
+        ASSERT_TRUE(rb.enqueue(input.data(), length));
+        ASSERT_TRUE(rb.enqueue(input.data() + length, length / 2));
+        ASSERT_EQ(rb.size(), length);
+
+        auto window = rb.latest(length);
+        ASSERT_EQ(window.samples.size(), length);
+        for (std::size_t idx = 0; idx < length; ++idx) {
+            ASSERT_EQ(window.samples[idx], static_cast<double>(length / 2 + idx));
+        }
+    }
+};
+
+TEST_F(MirroredRingBufferTest, PageMultipleIsMirrored) {
+    MirroredRingBuffer<double> rb(1024);
+#ifdef __linux__
+    EXPECT_TRUE(rb.mirrored());
+#endif
+    ExpectContiguousWindow(rb);
+}
+
+TEST_F(MirroredRingBufferTest, FallbackForOddSizes) {
+    MirroredRingBuffer<double> rb(130);
+    EXPECT_FALSE(rb.mirrored());
+    ExpectContiguousWindow(rb);
+
+    ASSERT_TRUE(rb.consume(100));
+    auto window = rb.oldest(30);
+    ASSERT_EQ(window.samples.size(), 30u);
+    EXPECT_EQ(window.samples[0], 165.0);
+}
+
+class SlidingWindowTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+};
+
+TEST_F(SlidingWindowTest, QuarterHopOverRingBuffer) {
+    // output_frame 8, sample_overlap 6 -> 75% overlap, hop of 2.
+    SlidingWindow<int> windows(8, 6);
+    RingBuffer<int> rb(16);
+    std::vector<int> input(13);
+    for (int idx = 0; idx < 13; ++idx) {
+        input[idx] = idx;
+    }
+    rb.enqueue(input.data(), 5);
+    rb.consume(5);
+    rb.enqueue(input.data(), 13); // sample 11 lands in slot 0.
+
+    std::vector<int> starts;
+    std::size_t visited = windows.process(rb, [&starts](const RingSpan<int> &window) {
+        ASSERT_EQ(window.size(), 8u);
+        starts.push_back(window[0]);
+        EXPECT_EQ(window[7], window[0] + 7);
+    });
+
+    EXPECT_EQ(visited, 3u);
+    EXPECT_EQ(starts, (std::vector<int>{0, 2, 4}));
+    EXPECT_EQ(rb.size(), 7u); // samples 6..12 are still needed.
+}
+
+TEST_F(SlidingWindowTest, ContiguousWindowsOverMirroredBuffer) {
+    SlidingWindow<double> windows(4, 2);
+    MirroredRingBuffer<double> rb(6);
+    const double input[] = {0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0};
+
+    rb.enqueue(input, 4);
+    rb.consume(4);
+    rb.enqueue(input + 2, 6); // 2..7 with the tail wrapped.
+
+    std::vector<double> starts;
+    windows.process(rb, [&starts](std::span<const double> window) {
+        starts.push_back(window[0]);
+        EXPECT_EQ(window[3], window[0] + 3.0);
+    });
+
+    EXPECT_EQ(starts, (std::vector<double>{2.0, 4.0}));
+    EXPECT_EQ(rb.size(), 2u);
+}
+
+class MpmcRingBufferTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+};
+
+TEST_F(MpmcRingBufferTest, RejectsWhenFull) {
+    MpmcRingBuffer<int> rb(4);
+    const int input[] = {1, 2, 3};
+    int out[3];
+
+    ASSERT_TRUE(rb.enqueue(input, 3));
+    EXPECT_FALSE(rb.enqueue(input, 2));
+    ASSERT_TRUE(rb.enqueue(input, 1));
+
+    ASSERT_TRUE(rb.dequeue(out, 3));
+    EXPECT_EQ(out[2], 3);
+    EXPECT_FALSE(rb.dequeue(out, 2));
+}
+
+TEST_F(MpmcRingBufferTest, ChunksFromSeveralProducersStayWhole) {
+    const int num_producers = 4;
+    const int num_chunks = 2000;
+    const int chunk = 8;
+    MpmcRingBuffer<int> rb(64);
+
+    std::vector<std::thread> producers;
+    for (int id = 0; id < num_producers; ++id) {
+        producers.emplace_back([&rb, id] {
+            int items[chunk];
+            for (int seq = 0; seq < num_chunks; ++seq) {
+                for (int idx = 0; idx < chunk; ++idx) {
+                    items[idx] = id * 1000000 + seq * chunk + idx;
+                }
+                while (!rb.enqueue(items, chunk)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> next(num_producers, 0);
+    int out[chunk];
+    for (int received = 0; received < num_producers * num_chunks;) {
+        if (!rb.dequeue(out, chunk)) {
+            std::this_thread::yield();
+            continue;
+        }
+        const int id = out[0] / 1000000;
+        for (int idx = 0; idx < chunk; ++idx) {
+            ASSERT_EQ(out[idx], id * 1000000 + next[id] + idx);
+        }
+        next[id] += chunk;
+        ++received;
+    }
+
+    for (auto &producer : producers) {
+        producer.join();
+    }
+    EXPECT_TRUE(rb.empty());
+}
@@ -0,0 +1,137 @@
+/* ================================================================================
+ * One-way latency benchmark between two local processes: ShmStreamer's
+ * shared-memory ring against the LSL path, both through StreamerFactory.
+ *
+ * A forked sender publishes one double per frame at 1 kHz, stamped with
+ * the monotonic clock, which both processes share; the receiver records
+ * how old every frame is when receive() returns it. Pass the number of
+ * frames as the first argument (default 5000) and "shm" or "lsl" as the
+ * second to run only one transport.
+ * ================================================================================
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "../src/stream/streamer_factory.h"
+
+namespace
+{
+    constexpr double rate = 1000.0;
+
+    double monotonic_now()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void configure(StreamerInterface &streamer, const std::string &name)
+    {
+        streamer.set_name(name);
+        streamer.set_data_type("double");
+        streamer.set_num_channels(1);
+        streamer.set_sampling_rate(static_cast<std::size_t>(rate));
+    }
+
+    void send(const std::string &type, const std::string &name, std::size_t frames)
+    {
+        StreamerFactory factory;
+        std::unique_ptr<StreamerInterface> sender(factory.get_streamer(type));
+        configure(*sender, name);
+        if (!sender->open_output_stream())
+        {
+            return;
+        }
+
+        //-- Give the receiver time to connect, so no frame is sent into the void.
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+
+        auto next = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < frames; ++i)
+        {
+            next += std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / rate));
+            std::this_thread::sleep_until(next);
+
+            const double value = static_cast<double>(i);
+            const double stamp = monotonic_now();
+            sender->publish(std::span<const double>(&value, 1), std::span<const double>(&stamp, 1));
+        }
+
+        //-- Keep the stream up until the receiver has drained it.
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+
+    void run(const std::string &type, std::size_t frames)
+    {
+        const std::string name = "latency_benchmark_" + std::to_string(getpid());
+
+        const pid_t child = fork();
+        if (child == 0)
+        {
+            send(type, name, frames);
+            _exit(0);
+        }
+
+        StreamerFactory factory;
+        std::unique_ptr<StreamerInterface> receiver(factory.get_streamer(type));
+        configure(*receiver, name);
+        if (!receiver->open_input_stream())
+        {
+            std::cout << std::setw(4) << type << "  could not connect\n";
+            waitpid(child, nullptr, 0);
+            return;
+        }
+
+        std::vector<double> latencies;
+        latencies.reserve(frames);
+        std::vector<double> values(64);
+        std::vector<double> stamps(64);
+        std::size_t n;
+        while (latencies.size() < frames && (n = receiver->receive(values, stamps)) != 0)
+        {
+            const double now = monotonic_now();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                latencies.push_back((now - stamps[i]) * 1e6);
+            }
+        }
+        waitpid(child, nullptr, 0);
+
+        if (latencies.empty())
+        {
+            std::cout << std::setw(4) << type << "  no frames received\n";
+            return;
+        }
+
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&](double p)
+        { return latencies[static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1))]; };
+        std::cout << std::setw(4) << type << std::fixed << std::setprecision(1)
+                  << "  frames " << std::setw(6) << latencies.size()
+                  << "  p50 " << std::setw(8) << percentile(0.5) << " us"
+                  << "  p99 " << std::setw(8) << percentile(0.99) << " us"
+                  << "  max " << std::setw(8) << latencies.back() << " us\n";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const std::size_t frames = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 5000;
+    const std::string only = (argc > 2) ? argv[2] : "";
+
+    for (const std::string type : {"shm", "lsl"})
+    {
+        if (only.empty() || only == type)
+        {
+            run(type, frames);
+        }
+    }
+    return 0;
+}
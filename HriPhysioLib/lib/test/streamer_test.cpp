@@ -0,0 +1,1020 @@
+#include <gtest/gtest.h>
+#include "../src/stream/bin_streamer.h"
+#include "../src/stream/csv_streamer.h"
+#include "../src/stream/replay_streamer.h"
+#include "../src/stream/shm_streamer.h"
+#include "../src/stream/streamer_factory.h"
+#include "../src/stream/xdf_streamer.h"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+class StreamerTest : public ::testing::Test {
+protected:
+    std::filesystem::path path;
+
+    void SetUp() override {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        path = std::filesystem::temp_directory_path() /
+               (std::string("hri_physio_") + info->name() + ".csv");
+    }
+
+    void TearDown() override {
+        std::filesystem::remove(path);
+    }
+
+    // Reads every row of the file, split on commas.
+    std::vector<std::vector<std::string>> ReadRows() {
+        std::vector<std::vector<std::string>> rows;
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            std::vector<std::string> fields;
+            std::stringstream ss(line);
+            std::string field;
+            while (std::getline(ss, field, ',')) {
+                fields.push_back(field);
+            }
+            rows.push_back(fields);
+        }
+        return rows;
+    }
+};
+
+TEST_F(StreamerTest, VarTagOfMapsElementTypes) {
+    EXPECT_EQ(var_tag_of<char>(), VarTag::CHAR);
+    EXPECT_EQ(var_tag_of<int8_t>(), VarTag::CHAR);
+    EXPECT_EQ(var_tag_of<int16_t>(), VarTag::INT16);
+    EXPECT_EQ(var_tag_of<int32_t>(), VarTag::INT32);
+    EXPECT_EQ(var_tag_of<int64_t>(), VarTag::INT64);
+    EXPECT_EQ(var_tag_of<float>(), VarTag::FLOAT);
+    EXPECT_EQ(var_tag_of<double>(), VarTag::DOUBLE);
+}
+
+TEST_F(StreamerTest, CsvPublishesTypedFrames) {
+    {
+        CSVStreamer csv;
+        csv.set_name(path.string());
+        csv.set_data_type("int16");
+        csv.set_num_channels(2);
+        ASSERT_TRUE(csv.open_output_stream());
+
+        std::vector<int16_t> frames = {1, 2, 3, 4, 5, 6};
+        std::vector<double> timestamps = {0.5, 1.5, 2.5};
+        EXPECT_TRUE(csv.publish(frames, timestamps));
+
+        // A span over a caller-owned array works without copying.
+        int16_t raw[] = {7, 8};
+        EXPECT_TRUE(csv.publish(std::span<const int16_t>(raw)));
+    }
+
+    auto rows = ReadRows();
+    ASSERT_EQ(rows.size(), 4u);
+    EXPECT_EQ(rows[0][1], "0.5");
+    EXPECT_EQ(rows[0][2], "1");
+    EXPECT_EQ(rows[0][3], "2");
+    EXPECT_EQ(rows[2][1], "2.5");
+    EXPECT_EQ(rows[2][3], "6");
+    EXPECT_EQ(rows[3][1], "0");
+    EXPECT_EQ(rows[3][2], "7");
+}
+
+TEST_F(StreamerTest, CsvWritesInt8AsNumbers) {
+    {
+        CSVStreamer csv;
+        csv.set_name(path.string());
+        csv.set_data_type("int8");
+        csv.set_num_channels(1);
+        ASSERT_TRUE(csv.open_output_stream());
+        std::vector<int8_t> frames = {65, -3};
+        EXPECT_TRUE(csv.publish(frames));
+    }
+
+    auto rows = ReadRows();
+    ASSERT_EQ(rows.size(), 2u);
+    EXPECT_EQ(rows[0][2], "65");
+    EXPECT_EQ(rows[1][2], "-3");
+}
+
+TEST_F(StreamerTest, PublishRejectsMismatchedType) {
+    CSVStreamer csv;
+    csv.set_name(path.string());
+    csv.set_data_type("double");
+    csv.set_num_channels(1);
+    ASSERT_TRUE(csv.open_output_stream());
+
+    std::vector<float> wrong = {1.0f};
+    EXPECT_FALSE(csv.publish(wrong));
+    std::vector<double> right = {1.0};
+    EXPECT_TRUE(csv.publish(right));
+}
+
+TEST_F(StreamerTest, OpenChecksFormat) {
+    CSVStreamer unknown;
+    unknown.set_name(path.string());
+    EXPECT_FALSE(unknown.set_data_type("complex"));
+    unknown.set_num_channels(1);
+    EXPECT_FALSE(unknown.open_output_stream());
+
+    CSVStreamer no_channels;
+    no_channels.set_name(path.string());
+    no_channels.set_data_type("double");
+    EXPECT_FALSE(no_channels.open_output_stream());
+}
+
+TEST_F(StreamerTest, PublishNeedsOpenStream) {
+    CSVStreamer csv;
+    csv.set_name(path.string());
+    csv.set_data_type("double");
+    csv.set_num_channels(1);
+
+    std::vector<double> frames = {1.0};
+    EXPECT_FALSE(csv.publish(frames));
+}
+
+TEST_F(StreamerTest, FactoryStreamersUseTheInterface) {
+    StreamerFactory factory;
+    std::unique_ptr<StreamerInterface> streamer(factory.get_streamer("CSV"));
+    ASSERT_NE(streamer, nullptr);
+
+    streamer->set_name(path.string());
+    streamer->set_data_type("float");
+    streamer->set_num_channels(3);
+    ASSERT_TRUE(streamer->open_output_stream());
+
+    std::vector<float> frame = {1.0f, 2.0f, 3.0f};
+    EXPECT_TRUE(streamer->publish(frame));
+    streamer.reset();
+
+    auto rows = ReadRows();
+    ASSERT_EQ(rows.size(), 1u);
+    EXPECT_EQ(rows[0].size(), 5u);
+}
+
+TEST_F(StreamerTest, CsvWritesDoublesExactly) {
+    {
+        CSVStreamer csv;
+        csv.set_name(path.string());
+        csv.set_data_type("double");
+        csv.set_num_channels(2);
+        ASSERT_TRUE(csv.open_output_stream());
+        std::vector<double> frame = {0.1234567891234, -2.5e-7};
+        std::vector<double> timestamps = {12345.678901234};
+        EXPECT_TRUE(csv.publish(frame, timestamps));
+    }
+
+    auto rows = ReadRows();
+    ASSERT_EQ(rows.size(), 1u);
+    EXPECT_EQ(rows[0][0].size(), 19u);
+    EXPECT_EQ(rows[0][1], "12345.6789");
+    EXPECT_EQ(std::stod(rows[0][2]), 0.1234567891234);
+    EXPECT_EQ(std::stod(rows[0][3]), -2.5e-7);
+}
+
+TEST_F(StreamerTest, CsvBufferedWriterHoldsRowsUntilFlush) {
+    CSVStreamer csv;
+    csv.set_name(path.string());
+    csv.set_data_type("int32");
+    csv.set_num_channels(1);
+    csv.set_write_buffer(1 << 20, 60.0);
+    ASSERT_TRUE(csv.open_output_stream());
+
+    std::vector<int32_t> frames(100, 42);
+    EXPECT_TRUE(csv.publish(frames));
+    EXPECT_EQ(std::filesystem::file_size(path), 0u);
+
+    csv.flush();
+    EXPECT_EQ(ReadRows().size(), 100u);
+}
+
+TEST_F(StreamerTest, CsvBufferedWriterFlushesWhenFull) {
+    CSVStreamer csv;
+    csv.set_name(path.string());
+    csv.set_data_type("int32");
+    csv.set_num_channels(1);
+    csv.set_write_buffer(1024, 60.0);
+    ASSERT_TRUE(csv.open_output_stream());
+
+    std::vector<int32_t> frames(200, 42);
+    EXPECT_TRUE(csv.publish(frames));
+    EXPECT_GE(std::filesystem::file_size(path), 1024u);
+}
+
+TEST_F(StreamerTest, CsvStringRowsAreQuoted) {
+    {
+        CSVStreamer csv;
+        csv.set_name(path.string());
+        csv.set_data_type("string");
+        csv.set_num_channels(1);
+        ASSERT_TRUE(csv.open_output_stream());
+        double time = 1.5;
+        csv.publish(std::string("hello robot"), &time);
+    }
+
+    auto rows = ReadRows();
+    ASSERT_EQ(rows.size(), 1u);
+    EXPECT_EQ(rows[0][1], "1.5");
+    EXPECT_EQ(rows[0][2], "\"hello robot\"");
+}
+
+TEST_F(StreamerTest, CsvReadsBackWhatItWrote) {
+    std::vector<double> written(3 * 50);
+    std::vector<double> written_times(50);
+    for (std::size_t i = 0; i < written.size(); ++i) {
+        written[i] = 0.1 * static_cast<double>(i) - 3.0;
+    }
+    for (std::size_t i = 0; i < written_times.size(); ++i) {
+        written_times[i] = 1000.0 + 0.125 * static_cast<double>(i);
+    }
+    {
+        CSVStreamer csv;
+        csv.set_name(path.string());
+        csv.set_data_type("double");
+        csv.set_num_channels(3);
+        ASSERT_TRUE(csv.open_output_stream());
+        ASSERT_TRUE(csv.publish(written, written_times));
+    }
+
+    CSVStreamer csv;
+    csv.set_name(path.string());
+    csv.set_data_type("double");
+    csv.set_num_channels(3);
+    ASSERT_TRUE(csv.open_input_stream());
+
+    // Timestamps fit in the 10 digits the writer keeps. Read in chunks of 7 frames into the same buffers.
+    std::vector<double> chunk(3 * 7);
+    std::vector<double> times(7);
+    std::vector<double> read, read_times;
+    std::size_t n;
+    while ((n = csv.receive(chunk, times)) != 0) {
+        ASSERT_EQ(n % 3, 0u);
+        read.insert(read.end(), chunk.begin(), chunk.begin() + n);
+        read_times.insert(read_times.end(), times.begin(), times.begin() + n / 3);
+    }
+
+    EXPECT_EQ(read, written);
+    EXPECT_EQ(read_times, written_times);
+}
+
+TEST_F(StreamerTest, CsvReadsHeaderedSingleColumnFiles) {
+    {
+        std::ofstream file(path);
+        file << "ECG_Data\r\n0.5\r\n-1.25\r\n\r\n+2e-3\r\n";
+    }
+
+    CSVStreamer csv;
+    csv.set_name(path.string());
+    csv.set_data_type("float");
+    csv.set_num_channels(1);
+    ASSERT_TRUE(csv.open_input_stream());
+
+    float samples[8];
+    double times[8];
+    ASSERT_EQ(csv.receive(std::span<float>(samples), std::span<double>(times)), 3u);
+    EXPECT_EQ(samples[0], 0.5f);
+    EXPECT_EQ(samples[1], -1.25f);
+    EXPECT_EQ(samples[2], 2e-3f);
+    EXPECT_EQ(times[0], 0.0);
+    EXPECT_EQ(csv.receive(std::span<float>(samples)), 0u);
+}
+
+TEST_F(StreamerTest, CsvReadsIntegerChannels) {
+    {
+        std::ofstream file(path);
+        file << "2024/01/01_00:00:00,1.5,-7,100\n"
+                "2024/01/01_00:00:00,2.5,bad,1\n"
+                "2024/01/01_00:00:00,3.0,9,300\n"
+                "2024/01/01_00:00:01,3.5,8,-100\n";
+    }
+
+    CSVStreamer csv;
+    csv.set_name(path.string());
+    csv.set_data_type("int8");
+    csv.set_num_channels(2);
+    ASSERT_TRUE(csv.open_input_stream());
+
+    std::vector<int8_t> samples(8);
+    std::vector<double> times(4);
+    ASSERT_EQ(csv.receive(samples, times), 4u);
+    EXPECT_EQ(samples[0], -7);
+    EXPECT_EQ(samples[1], 100);
+    EXPECT_EQ(samples[2], 8);
+    EXPECT_EQ(samples[3], -100);
+    EXPECT_EQ(times[1], 3.5);
+}
+
+TEST_F(StreamerTest, CsvReadsAChosenColumn) {
+    {
+        std::ofstream file(path);
+        file << "ECG,EDA\n0.5,7\n-1.25,8\n1\n";
+    }
+
+    CSVStreamer csv;
+    csv.set_name(path.string());
+    csv.set_data_type("double");
+    csv.set_num_channels(1);
+    csv.set_input_column(0);
+    ASSERT_TRUE(csv.open_input_stream());
+
+    double samples[4];
+    double times[4];
+    ASSERT_EQ(csv.receive(std::span<double>(samples), std::span<double>(times)), 3u);
+    EXPECT_EQ(samples[0], 0.5);
+    EXPECT_EQ(samples[1], -1.25);
+    EXPECT_EQ(samples[2], 1.0);
+    EXPECT_EQ(times[0], 0.0);
+}
+
+TEST_F(StreamerTest, CsvInputFailsForMissingFile) {
+    CSVStreamer csv;
+    csv.set_name((path.string() + ".missing"));
+    csv.set_data_type("double");
+    csv.set_num_channels(1);
+    EXPECT_FALSE(csv.open_input_stream());
+}
+
+class BinStreamerTest : public StreamerTest {
+protected:
+    // Writes LSL-style chunks: interleaved frames with one timestamp each, at 130 Hz.
+    void WriteChunks(const std::vector<std::size_t>& chunk_frames, std::size_t channels,
+                     std::vector<float>& samples, std::vector<double>& stamps,
+                     bool with_index = true) {
+        BinStreamer bin;
+        bin.set_name(path.string());
+        bin.set_data_type("float");
+        bin.set_num_channels(channels);
+        bin.set_sampling_rate(130);
+        bin.set_stream_name("ECG");
+        bin.set_index(with_index, 16);
+        ASSERT_TRUE(bin.open_output_stream());
+
+        for (std::size_t frames : chunk_frames) {
+            std::vector<float> chunk(frames * channels);
+            std::vector<double> chunk_stamps(frames);
+            for (std::size_t i = 0; i < frames; ++i) {
+                chunk_stamps[i] = 100.0 + static_cast<double>(stamps.size() + i) / 130.0;
+            }
+            for (std::size_t i = 0; i < chunk.size(); ++i) {
+                chunk[i] = static_cast<float>(samples.size() + i) * 0.5f;
+            }
+            ASSERT_TRUE(bin.publish(chunk, chunk_stamps));
+            samples.insert(samples.end(), chunk.begin(), chunk.end());
+            stamps.insert(stamps.end(), chunk_stamps.begin(), chunk_stamps.end());
+        }
+    }
+};
+
+TEST_F(BinStreamerTest, RoundTripsChunksAndHeader) {
+    std::vector<float> samples;
+    std::vector<double> stamps;
+    WriteChunks({1, 13, 64, 7, 200, 3}, 4, samples, stamps);
+
+    BinStreamer bin;
+    bin.set_name(path.string());
+    ASSERT_TRUE(bin.open_input_stream());
+    EXPECT_EQ(bin.get_var_tag(), VarTag::FLOAT);
+    EXPECT_EQ(bin.get_num_channels(), 4u);
+    EXPECT_EQ(bin.get_sampling_rate(), 130u);
+    EXPECT_EQ(bin.get_stream_name(), "ECG");
+
+    // Chunks of 10 frames cross every block boundary.
+    std::vector<float> chunk(4 * 10);
+    std::vector<double> chunk_stamps(10);
+    std::vector<float> read;
+    std::vector<double> read_stamps;
+    std::size_t n;
+    while ((n = bin.receive(chunk, chunk_stamps)) != 0) {
+        read.insert(read.end(), chunk.begin(), chunk.begin() + n);
+        read_stamps.insert(read_stamps.end(), chunk_stamps.begin(), chunk_stamps.begin() + n / 4);
+    }
+
+    EXPECT_EQ(read, samples);
+    EXPECT_EQ(read_stamps, stamps);
+}
+
+TEST_F(BinStreamerTest, FramesWithoutTimestampsReadAsZero) {
+    {
+        BinStreamer bin;
+        bin.set_name(path.string());
+        bin.set_data_type("int32");
+        bin.set_num_channels(2);
+        ASSERT_TRUE(bin.open_output_stream());
+        std::vector<int32_t> frames = {1, -2, 3, -4};
+        ASSERT_TRUE(bin.publish(frames));
+    }
+
+    BinStreamer bin;
+    bin.set_name(path.string());
+    ASSERT_TRUE(bin.open_input_stream());
+    EXPECT_EQ(bin.get_stream_name(), path.stem().string());
+
+    std::vector<int32_t> frames(4);
+    std::vector<double> stamps(2, -1.0);
+    ASSERT_EQ(bin.receive(frames, stamps), 4u);
+    EXPECT_EQ(frames, (std::vector<int32_t>{1, -2, 3, -4}));
+    EXPECT_EQ(stamps, (std::vector<double>{0.0, 0.0}));
+
+    // The file holds int32, so reading it as double is refused.
+    std::vector<double> wrong(4);
+    EXPECT_EQ(bin.receive(wrong), 0u);
+}
+
+TEST_F(BinStreamerTest, SeeksWithAndWithoutIndex) {
+    for (bool with_index : {true, false}) {
+        std::vector<float> samples;
+        std::vector<double> stamps;
+        WriteChunks(std::vector<std::size_t>(50, 9), 2, samples, stamps, with_index);
+
+        BinStreamer bin;
+        bin.set_name(path.string());
+        ASSERT_TRUE(bin.open_input_stream());
+
+        // Between two samples, the reader lands on the later one.
+        const std::size_t target = 301;
+        ASSERT_TRUE(bin.seek(stamps[target] - 1e-6));
+
+        std::vector<float> frame(2);
+        std::vector<double> stamp(1);
+        ASSERT_EQ(bin.receive(frame, stamp), 2u);
+        EXPECT_EQ(stamp[0], stamps[target]);
+        EXPECT_EQ(frame[0], samples[2 * target]);
+
+        EXPECT_FALSE(bin.seek(stamps.back() + 1.0));
+        ASSERT_TRUE(bin.seek(0.0));
+        ASSERT_EQ(bin.receive(frame, stamp), 2u);
+        EXPECT_EQ(stamp[0], stamps[0]);
+    }
+}
+
+TEST_F(BinStreamerTest, SeekToZeroInUnstampedFileStartsAtFirstFrame) {
+    {
+        BinStreamer bin;
+        bin.set_name(path.string());
+        bin.set_data_type("int32");
+        bin.set_num_channels(1);
+        bin.set_index(true, 4);
+        ASSERT_TRUE(bin.open_output_stream());
+        // Every block is indexed with a first timestamp of 0.
+        for (int32_t block = 0; block < 8; ++block) {
+            std::vector<int32_t> frames = {4 * block, 4 * block + 1, 4 * block + 2, 4 * block + 3};
+            ASSERT_TRUE(bin.publish(frames));
+        }
+    }
+
+    BinStreamer bin;
+    bin.set_name(path.string());
+    ASSERT_TRUE(bin.open_input_stream());
+    std::vector<int32_t> skipped(10);
+    ASSERT_EQ(bin.receive(skipped), 10u);
+
+    ASSERT_TRUE(bin.seek(0.0));
+    std::vector<int32_t> frames(32);
+    ASSERT_EQ(bin.receive(frames), 32u);
+    EXPECT_EQ(frames[0], 0);
+    EXPECT_EQ(frames[31], 31);
+}
+
+TEST_F(BinStreamerTest, TruncatedRecordingReadsCompleteBlocks) {
+    std::vector<float> samples;
+    std::vector<double> stamps;
+    WriteChunks({5, 5, 5}, 1, samples, stamps);
+
+    // Drop the end marker, the single index entry and the trailer, then cut
+    // into the last block, as a crash while writing would.
+    const auto size = std::filesystem::file_size(path);
+    std::filesystem::resize_file(path, size - 4 - 24 - 24 - 6);
+
+    BinStreamer bin;
+    bin.set_name(path.string());
+    ASSERT_TRUE(bin.open_input_stream());
+
+    std::vector<float> read(100);
+    EXPECT_EQ(bin.receive(read), 10u);
+}
+
+TEST_F(BinStreamerTest, FactoryCreatesBinStreamer) {
+    StreamerFactory factory;
+    std::unique_ptr<StreamerInterface> writer(factory.get_streamer("bin"));
+    ASSERT_NE(writer, nullptr);
+    writer->set_name(path.string());
+    writer->set_data_type("double");
+    writer->set_num_channels(2);
+    ASSERT_TRUE(writer->open_output_stream());
+
+    // The CLI records its input and Hilbert transform as two channels this way.
+    std::vector<double> frames = {0.25, 0.5, -0.75, 1.0};
+    ASSERT_TRUE(writer->publish(frames));
+    writer.reset();
+
+    std::unique_ptr<StreamerInterface> reader(factory.get_streamer("BIN"));
+    reader->set_name(path.string());
+    ASSERT_TRUE(reader->open_input_stream());
+    std::vector<double> read(4);
+    ASSERT_EQ(reader->receive(read), 4u);
+    EXPECT_EQ(read, frames);
+}
+
+TEST_F(StreamerTest, XdfRoundTripsSamplesAndHeader) {
+    std::vector<int32_t> samples;
+    std::vector<double> stamps;
+    {
+        XDFStreamer xdf;
+        xdf.set_name(path.string());
+        xdf.set_data_type("int32");
+        xdf.set_num_channels(3);
+        xdf.set_sampling_rate(250);
+        xdf.set_stream_name("EMG <left>");
+        xdf.set_stream_type("EMG");
+        ASSERT_TRUE(xdf.open_output_stream());
+
+        for (std::size_t frames : {1, 90, 5}) {
+            std::vector<int32_t> chunk(frames * 3);
+            std::vector<double> chunk_stamps(frames);
+            for (std::size_t i = 0; i < frames; ++i) {
+                chunk_stamps[i] = 50.0 + static_cast<double>(stamps.size() + i) / 250.0;
+            }
+            for (std::size_t i = 0; i < chunk.size(); ++i) {
+                chunk[i] = static_cast<int32_t>(samples.size() + i) - 100;
+            }
+            ASSERT_TRUE(xdf.publish(chunk, chunk_stamps));
+            samples.insert(samples.end(), chunk.begin(), chunk.end());
+            stamps.insert(stamps.end(), chunk_stamps.begin(), chunk_stamps.end());
+        }
+    }
+
+    XDFStreamer xdf;
+    xdf.set_name(path.string());
+    ASSERT_TRUE(xdf.open_input_stream());
+    EXPECT_EQ(xdf.get_var_tag(), VarTag::INT32);
+    EXPECT_EQ(xdf.get_num_channels(), 3u);
+    EXPECT_EQ(xdf.get_sampling_rate(), 250u);
+    EXPECT_EQ(xdf.get_stream_name(), "EMG <left>");
+
+    // Chunks of 7 frames cross every Samples chunk boundary.
+    std::vector<int32_t> chunk(3 * 7);
+    std::vector<double> chunk_stamps(7);
+    std::vector<int32_t> read;
+    std::vector<double> read_stamps;
+    std::size_t n;
+    while ((n = xdf.receive(chunk, chunk_stamps)) != 0) {
+        read.insert(read.end(), chunk.begin(), chunk.begin() + n);
+        read_stamps.insert(read_stamps.end(), chunk_stamps.begin(), chunk_stamps.begin() + n / 3);
+    }
+
+    EXPECT_EQ(read, samples);
+    EXPECT_EQ(read_stamps, stamps);
+}
+
+TEST_F(StreamerTest, XdfStreamsShareOneFile) {
+    {
+        XDFStreamer ecg;
+        ecg.set_name(path.string());
+        ecg.set_data_type("double");
+        ecg.set_num_channels(1);
+        ecg.set_stream_name("ECG");
+        ASSERT_TRUE(ecg.open_output_stream());
+
+        XDFStreamer markers;
+        markers.set_writer(ecg.get_writer());
+        markers.set_data_type("int16");
+        markers.set_num_channels(1);
+        markers.set_stream_name("Markers");
+        ASSERT_TRUE(markers.open_output_stream());
+
+        const double stamp = 1.5;
+        for (int i = 0; i < 4; ++i) {
+            std::vector<double> ecg_sample = {0.25 * i};
+            std::vector<int16_t> marker = {static_cast<int16_t>(10 + i)};
+            ASSERT_TRUE(ecg.publish(ecg_sample, std::span<const double>(&stamp, 1)));
+            ASSERT_TRUE(markers.publish(marker, std::span<const double>(&stamp, 1)));
+        }
+        ASSERT_TRUE(markers.add_clock_offset(2.0, -0.125));
+        ASSERT_TRUE(ecg.add_clock_offset(3.0, 0.5));
+    }
+
+    XDFStreamer markers;
+    markers.set_name(path.string());
+    markers.set_stream_name("Markers");
+    ASSERT_TRUE(markers.open_input_stream());
+    EXPECT_EQ(markers.get_var_tag(), VarTag::INT16);
+    std::vector<int16_t> read(8);
+    ASSERT_EQ(markers.receive(read), 4u);
+    EXPECT_EQ(read[0], 10);
+    EXPECT_EQ(read[3], 13);
+    ASSERT_EQ(markers.get_clock_offsets().size(), 1u);
+    EXPECT_EQ(markers.get_clock_offsets()[0].collection_time, 2.0);
+    EXPECT_EQ(markers.get_clock_offsets()[0].offset, -0.125);
+
+    // Without a name, the first stream in the file is read.
+    XDFStreamer ecg;
+    ecg.set_name(path.string());
+    ASSERT_TRUE(ecg.open_input_stream());
+    EXPECT_EQ(ecg.get_stream_name(), "ECG");
+    std::vector<double> samples(8);
+    ASSERT_EQ(ecg.receive(samples), 4u);
+    EXPECT_EQ(samples[3], 0.75);
+
+    XDFStreamer missing;
+    missing.set_name(path.string());
+    missing.set_stream_name("EEG");
+    EXPECT_FALSE(missing.open_input_stream());
+}
+
+TEST_F(StreamerTest, XdfDeducesMissingTimestampsFromRate) {
+    {
+        XDFStreamer xdf;
+        xdf.set_name(path.string());
+        xdf.set_data_type("float");
+        xdf.set_num_channels(2);
+        xdf.set_sampling_rate(4);
+        ASSERT_TRUE(xdf.open_output_stream());
+
+        std::vector<float> first = {1.0f, 2.0f};
+        const double stamp = 10.0;
+        ASSERT_TRUE(xdf.publish(first, std::span<const double>(&stamp, 1)));
+        std::vector<float> rest = {3.0f, 4.0f, 5.0f, 6.0f};
+        ASSERT_TRUE(xdf.publish(rest));
+    }
+
+    XDFStreamer xdf;
+    xdf.set_name(path.string());
+    ASSERT_TRUE(xdf.open_input_stream());
+    std::vector<float> samples(6);
+    std::vector<double> stamps(3);
+    ASSERT_EQ(xdf.receive(samples, stamps), 6u);
+    EXPECT_EQ(samples, (std::vector<float>{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}));
+    EXPECT_EQ(stamps, (std::vector<double>{10.0, 10.25, 10.5}));
+}
+
+TEST_F(StreamerTest, XdfRejectsOtherFilesAndStrings) {
+    {
+        std::ofstream file(path);
+        file << "1,2,3\n";
+    }
+    XDFStreamer reader;
+    reader.set_name(path.string());
+    EXPECT_FALSE(reader.open_input_stream());
+
+    StreamerFactory factory;
+    std::unique_ptr<StreamerInterface> writer(factory.get_streamer("xdf"));
+    ASSERT_NE(writer, nullptr);
+    writer->set_name(path.string());
+    writer->set_data_type("string");
+    writer->set_num_channels(1);
+    EXPECT_FALSE(writer->open_output_stream());
+}
+
+TEST_F(BinStreamerTest, ReplayAsFastAsPossibleFillsEveryReceive) {
+    std::vector<float> samples;
+    std::vector<double> stamps;
+    WriteChunks({1, 13, 64, 7, 200, 3}, 4, samples, stamps);
+
+    // The file is named .csv, so the format is given explicitly. Small prefetch chunks make the reader wait on the queue.
+    ReplayStreamer replay;
+    replay.set_name(path.string());
+    replay.set_source_type("bin");
+    replay.set_speed(ReplayStreamer::as_fast_as_possible);
+    replay.set_prefetch(50, 2);
+    ASSERT_TRUE(replay.open_input_stream());
+    EXPECT_EQ(replay.get_var_tag(), VarTag::FLOAT);
+    EXPECT_EQ(replay.get_num_channels(), 4u);
+
+    std::vector<float> chunk(4 * 32);
+    std::vector<double> chunk_stamps(32);
+    std::vector<float> read;
+    std::vector<double> read_stamps;
+    std::size_t n;
+    while ((n = replay.receive(chunk, chunk_stamps)) != 0) {
+        if (read.size() + chunk.size() < samples.size()) {
+            EXPECT_EQ(n, chunk.size());
+        }
+        read.insert(read.end(), chunk.begin(), chunk.begin() + n);
+        read_stamps.insert(read_stamps.end(), chunk_stamps.begin(), chunk_stamps.begin() + n / 4);
+    }
+
+    EXPECT_EQ(read, samples);
+    EXPECT_EQ(read_stamps, stamps);
+}
+
+TEST_F(BinStreamerTest, ReplayPacesByRecordedTimestamps) {
+    std::vector<float> samples;
+    std::vector<double> stamps;
+    WriteChunks({40, 60}, 1, samples, stamps);
+
+    // 100 frames at 130 Hz span 0.76 s, replayed at four times the speed.
+    ReplayStreamer replay;
+    replay.set_name(path.string());
+    replay.set_source_type("BIN");
+    replay.set_speed(4.0);
+    ASSERT_TRUE(replay.open_input_stream());
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<float> chunk(1000);
+    std::vector<float> read;
+    std::size_t n = replay.receive(chunk);
+    EXPECT_LT(n, samples.size());
+    while (n != 0) {
+        read.insert(read.end(), chunk.begin(), chunk.begin() + n);
+        n = replay.receive(chunk);
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(read, samples);
+    EXPECT_GE(elapsed, (stamps.back() - stamps.front()) / 4.0 - 0.01);
+    EXPECT_LT(elapsed, 2.0);
+}
+
+TEST_F(BinStreamerTest, ReplayPacesByTimestampsStartingAtZero) {
+    {
+        BinStreamer bin;
+        bin.set_name(path.string());
+        bin.set_data_type("float");
+        bin.set_num_channels(1);
+        bin.set_sampling_rate(1000);
+        ASSERT_TRUE(bin.open_output_stream());
+        std::vector<float> frames = {1.0f, 2.0f, 3.0f, 4.0f};
+        std::vector<double> frame_stamps = {0.0, 0.01, 0.02, 0.3};
+        ASSERT_TRUE(bin.publish(frames, frame_stamps));
+    }
+
+    // Paced by the 1 kHz rate, the four frames would take 3 ms instead of 0.3 s.
+    ReplayStreamer replay;
+    replay.set_name(path.string());
+    replay.set_source_type("BIN");
+    ASSERT_TRUE(replay.open_input_stream());
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<float> chunk(4);
+    std::size_t total = 0;
+    std::size_t n;
+    while ((n = replay.receive(chunk)) != 0) {
+        total += n;
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(total, 4u);
+    EXPECT_GE(elapsed, 0.29);
+    EXPECT_LT(elapsed, 2.0);
+}
+
+TEST_F(BinStreamerTest, ReplayStopsWhileReadingAhead) {
+    std::vector<float> samples;
+    std::vector<double> stamps;
+    WriteChunks({200}, 2, samples, stamps);
+
+    // The reader is blocked on a full queue when the replay is closed.
+    ReplayStreamer replay;
+    replay.set_name(path.string());
+    replay.set_source_type("BIN");
+    replay.set_speed(ReplayStreamer::as_fast_as_possible);
+    replay.set_prefetch(1, 1);
+    ASSERT_TRUE(replay.open_input_stream());
+    std::vector<float> chunk(2);
+    EXPECT_EQ(replay.receive(chunk), 2u);
+    EXPECT_EQ(chunk[1], samples[1]);
+}
+
+TEST_F(StreamerTest, FactoryReplaysCsvRecordings) {
+    std::vector<double> written = {0.5, -1.0, 1.5, -2.0, 2.5, -3.0};
+    std::vector<double> written_times = {10.0, 10.5, 11.0};
+    {
+        CSVStreamer csv;
+        csv.set_name(path.string());
+        csv.set_data_type("double");
+        csv.set_num_channels(2);
+        ASSERT_TRUE(csv.open_output_stream());
+        ASSERT_TRUE(csv.publish(written, written_times));
+    }
+
+    StreamerFactory factory;
+    std::unique_ptr<StreamerInterface> replay(factory.get_streamer("replay"));
+    ASSERT_NE(replay, nullptr);
+    replay->set_name(path.string());
+    replay->set_data_type("double");
+    replay->set_num_channels(2);
+    static_cast<ReplayStreamer*>(replay.get())->set_speed(ReplayStreamer::as_fast_as_possible);
+    ASSERT_TRUE(replay->open_input_stream());
+    EXPECT_FALSE(replay->open_output_stream());
+
+    std::vector<double> read(8);
+    std::vector<double> read_times(4);
+    ASSERT_EQ(replay->receive(read, read_times), 6u);
+    read.resize(6);
+    read_times.resize(3);
+    EXPECT_EQ(read, written);
+    EXPECT_EQ(read_times, written_times);
+    EXPECT_EQ(replay->receive(read), 0u);
+}
+
+class ShmStreamerTest : public ::testing::Test {
+protected:
+    std::string stream;
+
+    void SetUp() override {
+        // Segments are host-wide, so the name includes the pid.
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        stream = std::string("test_") + info->name() + "_" + std::to_string(getpid());
+    }
+
+    void OpenSender(ShmStreamer& sender, std::size_t channels) {
+        sender.set_name(stream);
+        sender.set_data_type("double");
+        sender.set_num_channels(channels);
+        sender.set_sampling_rate(500);
+        sender.set_capacity(1);
+        ASSERT_TRUE(sender.open_output_stream());
+    }
+
+    void OpenReceiver(ShmStreamer& receiver) {
+        receiver.set_name(stream);
+        receiver.set_timeout(0.05);
+        ASSERT_TRUE(receiver.open_input_stream());
+    }
+};
+
+TEST_F(ShmStreamerTest, PeekIsContiguousAcrossTheWrap) {
+    ShmStreamer sender;
+    OpenSender(sender, 2);
+    ShmStreamer receiver;
+    OpenReceiver(receiver);
+    EXPECT_EQ(receiver.get_var_tag(), VarTag::DOUBLE);
+    EXPECT_EQ(receiver.get_num_channels(), 2u);
+    EXPECT_EQ(receiver.get_sampling_rate(), 500u);
+
+    // The capacity rounds up to one page of frames; move both sides to just before its end.
+    const std::size_t capacity = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    std::vector<double> filler(2 * (capacity - 50));
+    ASSERT_TRUE(sender.publish(filler));
+    std::vector<double> drained(filler.size());
+    ASSERT_EQ(receiver.receive(drained), filler.size());
+
+    std::vector<double> frames(2 * 200);
+    std::vector<double> stamps(200);
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        frames[i] = 0.5 * static_cast<double>(i);
+    }
+    for (std::size_t i = 0; i < stamps.size(); ++i) {
+        stamps[i] = 20.0 + 0.002 * static_cast<double>(i);
+    }
+    ASSERT_TRUE(sender.publish(frames, stamps));
+
+    std::span<const double> peeked_stamps;
+    std::span<const double> peeked = receiver.peek<double>(&peeked_stamps);
+    ASSERT_EQ(peeked.size(), frames.size());
+    EXPECT_TRUE(std::equal(peeked.begin(), peeked.end(), frames.begin()));
+    EXPECT_TRUE(std::equal(peeked_stamps.begin(), peeked_stamps.end(), stamps.begin()));
+    EXPECT_TRUE(receiver.consume(200));
+    EXPECT_FALSE(receiver.consume(1));
+
+    EXPECT_TRUE(receiver.peek<float>().empty());
+}
+
+TEST_F(ShmStreamerTest, FullRingRejectsPublish) {
+    ShmStreamer sender;
+    OpenSender(sender, 1);
+    ShmStreamer receiver;
+    OpenReceiver(receiver);
+
+    const std::size_t capacity = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    std::vector<double> frames(capacity, 1.0);
+    ASSERT_TRUE(sender.publish(frames));
+    std::vector<double> one = {2.0};
+    EXPECT_FALSE(sender.publish(one));
+    EXPECT_EQ(sender.get_dropped_frames(), 1u);
+
+    EXPECT_TRUE(receiver.consume(1));
+    EXPECT_TRUE(sender.publish(one));
+    EXPECT_EQ(receiver.peek<double>().back(), 2.0);
+}
+
+TEST_F(ShmStreamerTest, ReceiverDrainsAfterSenderCloses) {
+    ShmStreamer receiver;
+    {
+        ShmStreamer sender;
+        OpenSender(sender, 1);
+        OpenReceiver(receiver);
+
+        ShmStreamer second;
+        second.set_name(stream);
+        second.set_timeout(0.05);
+        EXPECT_FALSE(second.open_input_stream());
+
+        std::vector<double> empty(4);
+        EXPECT_EQ(receiver.receive(empty), 0u);
+
+        std::vector<double> frames = {1.0, 2.0, 3.0};
+        ASSERT_TRUE(sender.publish(frames));
+    }
+
+    std::vector<double> read(8);
+    EXPECT_EQ(receiver.receive(read), 3u);
+    EXPECT_EQ(read[2], 3.0);
+
+    // Once closed and drained, receive returns at once instead of waiting for the timeout.
+    receiver.set_timeout(10.0);
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(receiver.receive(read), 0u);
+    EXPECT_LT(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), 5.0);
+}
+
+TEST_F(ShmStreamerTest, StreamsBetweenTwoProcesses) {
+    constexpr std::size_t total = 20000;
+    constexpr std::size_t chunk = 100;
+
+    const pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        // The sender starts after the receiver is already waiting for it, and outruns it through a one-page ring.
+        // It is closed before _exit so the segment is removed, and gives up if the receiver stops draining.
+        bool sent_all = false;
+        {
+            ShmStreamer sender;
+            sender.set_name(stream);
+            sender.set_data_type("int32");
+            sender.set_num_channels(1);
+            sender.set_capacity(1);
+            if (sender.open_output_stream()) {
+                const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+                std::vector<int32_t> frames(chunk);
+                std::vector<double> stamps(chunk);
+                sent_all = true;
+                for (std::size_t sent = 0; sent < total && sent_all; sent += chunk) {
+                    for (std::size_t i = 0; i < chunk; ++i) {
+                        frames[i] = static_cast<int32_t>(sent + i);
+                        stamps[i] = static_cast<double>(sent + i) * 0.001;
+                    }
+                    while (!sender.publish(frames, stamps) && sent_all) {
+                        sent_all = std::chrono::steady_clock::now() < deadline;
+                        usleep(100);
+                    }
+                }
+            }
+        }
+        _exit(sent_all ? 0 : 1);
+    }
+
+    // A failed assertion returns early; the sender must not outlive the test.
+    struct ReapChild {
+        pid_t pid;
+        ~ReapChild() {
+            if (pid > 0) {
+                kill(pid, SIGKILL);
+                waitpid(pid, nullptr, 0);
+            }
+        }
+    } reap{child};
+
+    ShmStreamer receiver;
+    receiver.set_name(stream);
+    receiver.set_timeout(10.0);
+    ASSERT_TRUE(receiver.open_input_stream());
+    ASSERT_EQ(receiver.get_var_tag(), VarTag::INT32);
+
+    std::vector<int32_t> frames(256);
+    std::vector<double> stamps(256);
+    std::size_t received = 0;
+    bool in_order = true;
+    std::size_t n;
+    while (received < total && (n = receiver.receive(frames, stamps)) != 0) {
+        for (std::size_t i = 0; i < n; ++i, ++received) {
+            in_order = in_order && frames[i] == static_cast<int32_t>(received) &&
+                       stamps[i] == static_cast<double>(received) * 0.001;
+        }
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(child, &status, 0), child);
+    reap.pid = -1;
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    EXPECT_EQ(received, total);
+    EXPECT_TRUE(in_order);
+}
+
+TEST_F(ShmStreamerTest, FactoryCreatesShmStreamer) {
+    StreamerFactory factory;
+    std::unique_ptr<StreamerInterface> sender(factory.get_streamer("shm"));
+    ASSERT_NE(sender, nullptr);
+    sender->set_name(stream);
+    sender->set_data_type("float");
+    sender->set_num_channels(3);
+    ASSERT_TRUE(sender->open_output_stream());
+
+    std::unique_ptr<StreamerInterface> receiver(factory.get_streamer("SHM"));
+    receiver->set_name(stream);
+    ASSERT_TRUE(receiver->open_input_stream());
+    std::vector<float> frames = {1.0f, 2.0f, 3.0f};
+    ASSERT_TRUE(sender->publish(frames));
+    std::vector<float> read(3);
+    ASSERT_EQ(receiver->receive(read), 3u);
+    EXPECT_EQ(read, frames);
+}
@@ -0,0 +1,727 @@
+#include <gtest/gtest.h>
+#include "../src/manager/thread_manager.h"
+#include "../src/manager/task_pool.h"
+#include "../src/manager/loop_stats.h"
+#include "../src/manager/thread_options.h"
+#include "../src/manager/timer_wheel.h"
+#include "../src/manager/coroutine.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include <yaml-cpp/yaml.h>
+
+class ThreadManagerTest : public ::testing::Test {
+protected:
+    using clock = std::chrono::steady_clock;
+
+    // Runs a loop thread for the given time and returns the start time of every iteration.
+    std::vector<clock::time_point> RecordLoop(double period, double duration,
+                                              const std::function<void()>& work = [] {},
+                                              OverrunPolicy policy = OverrunPolicy::SKIP) {
+        std::mutex stamps_lock;
+        std::vector<clock::time_point> stamps;
+
+        ThreadManager manager;
+        manager.add_loop_thread([&] {
+            {
+                std::lock_guard<std::mutex> guard(stamps_lock);
+                stamps.push_back(clock::now());
+            }
+            work();
+        }, period, true, policy);
+
+        std::this_thread::sleep_for(std::chrono::duration<double>(duration));
+        manager.close();
+        return stamps;
+    }
+
+    // Circular mean of the stamps' phase within the period, and how tightly they cluster around
+    // it: 1 when every stamp sits on the same phase, near 0 when their phases are spread out.
+    static std::pair<double, double> Phase(const std::vector<clock::time_point>& stamps, double period) {
+        double x = 0.0, y = 0.0;
+        for (const auto& stamp : stamps) {
+            const double angle = 2.0 * M_PI * std::chrono::duration<double>(stamp - stamps.front()).count() / period;
+            x += std::cos(angle);
+            y += std::sin(angle);
+        }
+        return {std::atan2(y, x) * period / (2.0 * M_PI), std::hypot(x, y) / static_cast<double>(stamps.size())};
+    }
+
+    // Median distance of stamps[from:] to the nearest deadline, phase + k * period. Skipped
+    // periods and a few late wake-ups do not count, while a loop that drifts moves off its
+    // deadlines for good and leaves them, at the latest, by the end of the run.
+    static double PhaseError(const std::vector<clock::time_point>& stamps, double period, std::size_t from = 0) {
+        const double phase = Phase(stamps, period).first;
+        std::vector<double> errors;
+        for (std::size_t i = from; i < stamps.size(); ++i) {
+            const double t = std::chrono::duration<double>(stamps[i] - stamps.front()).count() - phase;
+            errors.push_back(std::abs(t - std::round(t / period) * period));
+        }
+        std::nth_element(errors.begin(), errors.begin() + errors.size() / 2, errors.end());
+        return errors[errors.size() / 2];
+    }
+
+    // Mean period of the loop, fitted by least squares to the stamps against their deadline
+    // index k. The index comes from the period within 2 ms of the nominal one on which the
+    // stamps share a phase best, so skipped periods only move k on. Stamps more than 1 ms off
+    // their deadline are late wake-ups and left out of the fit.
+    static double FittedPeriod(const std::vector<clock::time_point>& stamps, double period) {
+        double phase_period = period;
+        auto [phase, best] = Phase(stamps, period);
+        for (int us = -2000; us <= 2000; ++us) {
+            const double candidate = period + us * 1e-6;
+            const auto [candidate_phase, clustering] = Phase(stamps, candidate);
+            if (clustering > best) {
+                best = clustering;
+                phase = candidate_phase;
+                phase_period = candidate;
+            }
+        }
+
+        double n = 0.0, sum_k = 0.0, sum_t = 0.0, sum_kk = 0.0, sum_kt = 0.0;
+        for (const auto& stamp : stamps) {
+            const double t = std::chrono::duration<double>(stamp - stamps.front()).count() - phase;
+            const double k = std::round(t / phase_period);
+            if (std::abs(t - k * phase_period) < 1e-3) {
+                n += 1.0;
+                sum_k += k;
+                sum_t += t;
+                sum_kk += k * k;
+                sum_kt += k * t;
+            }
+        }
+        if (n < 2.0) {
+            return phase_period;
+        }
+        return (n * sum_kt - sum_k * sum_t) / (n * sum_kk - sum_k * sum_k);
+    }
+};
+
+TEST_F(ThreadManagerTest, LoopPeriodDoesNotDrift) {
+    const double period = 0.01;
+    auto stamps = RecordLoop(period, 1.0);
+
+    ASSERT_GT(stamps.size(), 50u);
+    EXPECT_NEAR(FittedPeriod(stamps, period), period, 100e-6);
+    EXPECT_LT(PhaseError(stamps, period), 1e-3);
+    EXPECT_LT(PhaseError(stamps, period, stamps.size() * 4 / 5), 1e-3);
+}
+
+TEST_F(ThreadManagerTest, WorkTimeIsNotAddedToPeriod) {
+    const double period = 0.01;
+    auto stamps = RecordLoop(period, 0.5, [] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(4));
+    });
+
+    ASSERT_GT(stamps.size(), 20u);
+
+    // Adding the work time to the period would drift by 4 ms per iteration.
+    EXPECT_NEAR(FittedPeriod(stamps, period), period, 100e-6);
+    EXPECT_LT(PhaseError(stamps, period), 1e-3);
+    EXPECT_LT(PhaseError(stamps, period, stamps.size() * 4 / 5), 1e-3);
+}
+
+TEST_F(ThreadManagerTest, OverrunPolicies) {
+    // The first iteration overruns by several periods, the rest are quick.
+    auto slow_first = [] {
+        return [first = true]() mutable {
+            if (first) {
+                first = false;
+                std::this_thread::sleep_for(std::chrono::milliseconds(55));
+            }
+        };
+    };
+
+    auto skip = RecordLoop(0.01, 0.3, slow_first(), OverrunPolicy::SKIP);
+    auto catch_up = RecordLoop(0.01, 0.3, slow_first(), OverrunPolicy::CATCH_UP);
+
+    ASSERT_GT(skip.size(), 2u);
+    ASSERT_GT(catch_up.size(), 2u);
+
+    // Skipping resumes on the original phase, after the missed deadlines.
+    std::chrono::duration<double> gap = skip[1] - skip[0];
+    EXPECT_NEAR(gap.count(), 0.06, 0.005);
+
+    // Catching up runs the missed iterations back-to-back.
+    std::chrono::duration<double> burst = catch_up[2] - catch_up[1];
+    EXPECT_LT(burst.count(), 0.005);
+    EXPECT_GT(catch_up.size(), skip.size());
+}
+
+TEST_F(ThreadManagerTest, PausedLoopDoesNotRun) {
+    std::atomic<int> calls{0};
+    ThreadManager manager;
+    manager.add_loop_thread([&] { ++calls; }, 0.005, false);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(calls.load(), 0);
+
+    manager.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    manager.close();
+    EXPECT_GT(calls.load(), 0);
+}
+
+class TaskPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+};
+
+TEST_F(TaskPoolTest, SubmitReturnsResult) {
+    TaskPool pool(2);
+    auto result = pool.submit([] { return 6 * 7; });
+    EXPECT_EQ(result.get(), 42);
+    EXPECT_EQ(pool.size(), 2u);
+}
+
+TEST_F(TaskPoolTest, SubmitPropagatesExceptions) {
+    TaskPool pool(2);
+    auto result = pool.submit([]() -> int { throw std::runtime_error("failed"); });
+    EXPECT_THROW(result.get(), std::runtime_error);
+}
+
+TEST_F(TaskPoolTest, ParallelForVisitsEveryIndexOnce) {
+    TaskPool pool(3);
+    std::vector<std::atomic<int>> visits(1000);
+    pool.parallel_for(0, visits.size(), [&](std::size_t idx) { ++visits[idx]; });
+
+    for (size_t i = 0; i < visits.size(); ++i) {
+        EXPECT_EQ(visits[i].load(), 1) << "Index " << i;
+    }
+}
+
+TEST_F(TaskPoolTest, NestedParallelForDoesNotDeadlock) {
+    TaskPool pool(2);
+    std::atomic<int> total{0};
+    pool.parallel_for(0, 8, [&](std::size_t) {
+        pool.parallel_for(0, 8, [&](std::size_t) { ++total; }, 1);
+    }, 1);
+    EXPECT_EQ(total.load(), 64);
+}
+
+TEST_F(TaskPoolTest, IdleWorkerStealsQueuedTask) {
+    TaskPool pool(2);
+
+    // The child lands on the parent's own deque while the parent blocks without
+    // helping, so only the other worker stealing it can let the parent finish.
+    auto parent = pool.submit([&pool] {
+        auto child = pool.submit([] { return 1; });
+        return child.get() + 1;
+    });
+    EXPECT_EQ(parent.get(), 2);
+}
+
+TEST_F(TaskPoolTest, ThreadManagerForwardsToPool) {
+    ThreadManager manager;
+    manager.set_task_workers(2);
+
+    std::vector<int> squares(64);
+    manager.parallel_for(0, squares.size(), [&](std::size_t idx) {
+        squares[idx] = static_cast<int>(idx * idx);
+    });
+    EXPECT_EQ(squares[63], 63 * 63);
+
+    auto sum = manager.submit([&] { return std::accumulate(squares.begin(), squares.end(), 0); });
+    EXPECT_EQ(sum.get(), 85344);
+    EXPECT_EQ(manager.get_task_pool().size(), 2u);
+}
+
+TEST_F(ThreadManagerTest, HandleControlsSingleLoop) {
+    std::atomic<int> first_calls{0};
+    std::atomic<int> second_calls{0};
+    ThreadManager manager;
+    auto first = manager.add_loop_thread([&] { ++first_calls; }, 0.005);
+    auto second = manager.add_loop_thread([&] { ++second_calls; }, 0.005);
+
+    ASSERT_NE(first, nullptr);
+    EXPECT_TRUE(manager.get_thread_status(first->get_id()));
+
+    first->set_status(false);
+    EXPECT_FALSE(manager.get_thread_status(first->get_id()));
+    EXPECT_TRUE(second->get_status());
+
+    // Let any iteration that was already past the check finish.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    int paused = first_calls.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(first_calls.load(), paused);
+    EXPECT_GT(second_calls.load(), 0);
+
+    manager.stop();
+    EXPECT_FALSE(second->get_status());
+    manager.start();
+    EXPECT_TRUE(first->get_status());
+    EXPECT_TRUE(second->get_status());
+    manager.close();
+}
+
+TEST_F(ThreadManagerTest, CloseWakesSleepingAndPausedLoops) {
+    ThreadManager manager;
+    manager.add_loop_thread([] {}, 5.0);
+    manager.add_loop_thread([] {}, 0.01, false);
+
+    // Let the first loop run once and go to sleep for its long period.
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    auto before = clock::now();
+    manager.close();
+    std::chrono::duration<double> took = clock::now() - before;
+    EXPECT_LT(took.count(), 0.1);
+}
+
+TEST_F(ThreadManagerTest, WaitReturnsOnClose) {
+    ThreadManager manager;
+    manager.add_loop_thread([] {}, 0.01);
+
+    std::atomic<bool> returned{false};
+    clock::time_point returned_at;
+    std::thread waiter([&] {
+        manager.wait();
+        returned_at = clock::now();
+        returned = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_FALSE(returned.load());
+
+    auto closed_at = clock::now();
+    manager.close();
+    waiter.join();
+
+    EXPECT_TRUE(returned.load());
+    std::chrono::duration<double> latency = returned_at - closed_at;
+    EXPECT_LT(latency.count(), 0.1);
+}
+
+class LatencyHistogramTest : public ::testing::Test {
+protected:
+    void SetUp() override {}
+};
+
+TEST_F(LatencyHistogramTest, BucketsCoverEveryValue) {
+    for (std::uint64_t value : {0ull, 7ull, 8ull, 15ull, 16ull, 1000ull, 123456789ull}) {
+        std::size_t idx = LatencyHistogram::bucket_index(value);
+        EXPECT_LE(LatencyHistogram::bucket_lower(idx), value) << "Value " << value;
+        EXPECT_GT(LatencyHistogram::bucket_lower(idx + 1), value) << "Value " << value;
+    }
+    EXPECT_EQ(LatencyHistogram::bucket_index(~0ull), LatencyHistogram::num_buckets - 1);
+}
+
+TEST_F(LatencyHistogramTest, PercentilesWithinBucketPrecision) {
+    LatencyHistogram hist;
+    for (std::uint64_t us = 1; us <= 1000; ++us) {
+        hist.record(us * 1000);
+    }
+
+    HistogramSnapshot snap = hist.snapshot();
+    EXPECT_EQ(snap.count, 1000u);
+    EXPECT_NEAR(snap.mean(), 500.5e-6, 1e-9);
+    EXPECT_NEAR(snap.percentile(0.5), 500e-6, 500e-6 * 0.125);
+    EXPECT_NEAR(snap.percentile(0.99), 990e-6, 990e-6 * 0.125);
+    EXPECT_DOUBLE_EQ(snap.percentile(1.0), 1000e-6);
+
+    hist.reset();
+    EXPECT_EQ(hist.snapshot().count, 0u);
+    EXPECT_EQ(hist.snapshot().percentile(0.5), 0.0);
+}
+
+TEST_F(ThreadManagerTest, StatsRecordExecutionAndOverruns) {
+    ThreadManager manager;
+    auto quick = manager.add_loop_thread([] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }, 0.01);
+    auto slow = manager.add_loop_thread([] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(15));
+    }, 0.01);
+    manager.add_thread([] {});
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    auto all = manager.stats();
+    manager.close();
+
+    ASSERT_EQ(all.size(), 2u);
+    EXPECT_EQ(all[0].thread_id, quick->get_id());
+    EXPECT_EQ(all[1].thread_id, slow->get_id());
+
+    EXPECT_GT(all[0].execution.count, 10u);
+    EXPECT_NEAR(all[0].execution.percentile(0.5), 0.002, 0.001);
+    // A stalled VM can still push the odd iteration past its deadline.
+    EXPECT_LE(all[0].overruns * 10, all[0].execution.count);
+    EXPECT_EQ(all[0].jitter.count, all[0].execution.count);
+
+    EXPECT_GT(all[1].overruns, 0u);
+    EXPECT_GT(all[1].execution.max, 15000000u);
+}
+
+TEST_F(ThreadManagerTest, OptionsNameAndPinThread) {
+    ThreadOptions options;
+    options.name = "ecg_receive_loop_long";
+    options.cpus = {0};
+
+    std::mutex seen_lock;
+    std::string seen_name;
+    int seen_cpus = -1;
+    bool pinned_to_zero = false;
+
+    ThreadManager manager;
+    auto handle = manager.add_loop_thread([&] {
+        char name[16] = {};
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        sched_getaffinity(0, sizeof(set), &set);
+
+        std::lock_guard<std::mutex> guard(seen_lock);
+        seen_name = name;
+        seen_cpus = CPU_COUNT(&set);
+        pinned_to_zero = CPU_ISSET(0, &set);
+    }, 0.005, true, OverrunPolicy::SKIP, options);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    auto all = manager.stats();
+    manager.close();
+
+    EXPECT_EQ(seen_name, "ecg_receive_loo");
+    EXPECT_EQ(seen_cpus, 1);
+    EXPECT_TRUE(pinned_to_zero);
+    EXPECT_EQ(handle->get_name(), "ecg_receive_loop_long");
+    ASSERT_EQ(all.size(), 1u);
+    EXPECT_EQ(all[0].name, "ecg_receive_loop_long");
+}
+
+TEST_F(ThreadManagerTest, RealTimeRequestFallsBackGracefully) {
+    ThreadOptions options;
+    options.name = "rt_loop";
+    options.scheduling = SchedulingPolicy::FIFO;
+    options.priority = 1000;
+
+    // Whether or not the process may use SCHED_FIFO, the loop must still run.
+    std::atomic<int> calls{0};
+    std::atomic<int> policy{-1};
+    ThreadManager manager;
+    manager.add_loop_thread([&] {
+        sched_param param{};
+        int current = 0;
+        pthread_getschedparam(pthread_self(), &current, &param);
+        policy = current;
+        ++calls;
+    }, 0.005, true, OverrunPolicy::SKIP, options);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    manager.close();
+
+    EXPECT_GT(calls.load(), 0);
+    EXPECT_TRUE(policy.load() == SCHED_FIFO || policy.load() == SCHED_OTHER);
+}
+
+TEST_F(ThreadManagerTest, OptionsFromYaml) {
+    // The threads section of a robot config, as RobotManager::configure reads it.
+    YAML::Node config = YAML::Load(
+        "threads:\n"
+        "  self_loop:\n"
+        "    name: pepper_self\n"
+        "    cpus: [2, 3]\n"
+        "    scheduling: fifo\n"
+        "    priority: 40\n");
+
+    ThreadOptions self_loop = ThreadOptions::from_yaml(config["threads"]["self_loop"], "self_loop");
+    EXPECT_EQ(self_loop.name, "pepper_self");
+    EXPECT_EQ(self_loop.cpus, (std::vector<int>{2, 3}));
+    EXPECT_EQ(self_loop.scheduling, SchedulingPolicy::FIFO);
+    EXPECT_EQ(self_loop.priority, 40);
+
+    ThreadOptions input_loop = ThreadOptions::from_yaml(config["threads"]["input_loop"], "input_loop");
+    EXPECT_EQ(input_loop.name, "input_loop");
+    EXPECT_TRUE(input_loop.cpus.empty());
+    EXPECT_EQ(input_loop.scheduling, SchedulingPolicy::DEFAULT);
+    EXPECT_EQ(input_loop.priority, 0);
+}
+
+class TimerWheelTest : public ThreadManagerTest {};
+
+TEST_F(TimerWheelTest, PeriodicTimerKeepsPeriod) {
+    std::mutex stamps_lock;
+    std::vector<clock::time_point> stamps;
+    std::vector<double> lateness;
+
+    TimerWheel wheel;
+    wheel.schedule_every(0.01, [&] {
+        auto now = clock::now();
+        std::lock_guard<std::mutex> guard(stamps_lock);
+        stamps.push_back(now);
+        lateness.push_back(std::chrono::duration<double>(now - TimerWheel::scheduled_time()).count());
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(505));
+    std::lock_guard<std::mutex> guard(stamps_lock);
+
+    ASSERT_GE(stamps.size(), 45u);
+    EXPECT_LT(PhaseError(stamps, 0.01), 1e-3);
+    EXPECT_LT(PhaseError(stamps, 0.01, stamps.size() * 4 / 5), 1e-3);
+
+    // Never early, and usually within a tick plus the wake-up latency.
+    std::sort(lateness.begin(), lateness.end());
+    EXPECT_GE(lateness.front(), 0.0);
+    EXPECT_LT(lateness[lateness.size() / 2], 500e-6);
+}
+
+TEST_F(TimerWheelTest, OneShotFiresOnceAfterDelay) {
+    std::atomic<int> calls{0};
+    TimerWheel wheel;
+
+    auto scheduled = clock::now();
+    std::atomic<double> delay{0.0};
+    wheel.schedule_once(0.02, [&] {
+        delay = std::chrono::duration<double>(clock::now() - scheduled).count();
+        ++calls;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    EXPECT_EQ(calls.load(), 1);
+    EXPECT_GE(delay.load(), 0.02);
+    EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST_F(TimerWheelTest, CancelStopsTimer) {
+    std::atomic<int> calls{0};
+    TimerWheel wheel;
+    auto id = wheel.schedule_every(0.005, [&] { ++calls; });
+    auto never = wheel.schedule_once(0.02, [&] { calls += 1000; });
+
+    EXPECT_TRUE(wheel.cancel(never));
+    EXPECT_FALSE(wheel.cancel(never));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_TRUE(wheel.cancel(id));
+    int after_cancel = calls.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+
+    EXPECT_GT(after_cancel, 0);
+    EXPECT_LT(after_cancel, 1000);
+    EXPECT_EQ(calls.load(), after_cancel);
+}
+
+TEST_F(TimerWheelTest, LongDelaysCascadeThroughLevels) {
+    // With 10 us ticks, 0.05 s and 0.2 s sit on levels 2 and 3 of the wheel.
+    TimerWheel wheel(10e-6);
+    std::atomic<int> order{0};
+    std::atomic<int> first{0}, second{0};
+    auto start = clock::now();
+    std::atomic<double> second_at{0.0};
+
+    wheel.schedule_once(0.2, [&] {
+        second = ++order;
+        second_at = std::chrono::duration<double>(clock::now() - start).count();
+    });
+    wheel.schedule_once(0.05, [&] { first = ++order; });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_EQ(first.load(), 1);
+    EXPECT_EQ(second.load(), 2);
+    EXPECT_NEAR(second_at.load(), 0.2, 0.01);
+}
+
+TEST_F(TimerWheelTest, ManyTimersShareOneThread) {
+    std::mutex ids_lock;
+    std::vector<std::thread::id> ids;
+    std::atomic<int> calls{0};
+
+    TimerWheel wheel;
+    for (int i = 0; i < 100; ++i) {
+        wheel.schedule_every(0.002 + 0.0001 * i, [&] {
+            ++calls;
+            std::lock_guard<std::mutex> guard(ids_lock);
+            ids.push_back(std::this_thread::get_id());
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(wheel.size(), 100u);
+    EXPECT_GT(calls.load(), 100 * 10);
+
+    std::lock_guard<std::mutex> guard(ids_lock);
+    for (auto id : ids) {
+        EXPECT_EQ(id, wheel.get_id());
+    }
+}
+
+TEST_F(ThreadManagerTest, TimerLoopsFollowManagerState) {
+    std::atomic<int> calls{0};
+    ThreadManager manager;
+    auto handle = manager.add_timer_loop([&] { ++calls; }, 0.005, true, OverrunPolicy::SKIP, "hr_stream");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_GT(calls.load(), 3);
+    EXPECT_EQ(handle->get_id(), manager.get_timer_wheel().get_id());
+
+    manager.stop();
+    EXPECT_EQ(manager.get_timer_wheel().size(), 0u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    int paused = calls.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_EQ(calls.load(), paused);
+
+    auto all = manager.stats();
+    ASSERT_EQ(all.size(), 1u);
+    EXPECT_EQ(all[0].name, "hr_stream");
+    EXPECT_EQ(all[0].execution.count, static_cast<std::uint64_t>(paused));
+    manager.close();
+}
+
+TEST_F(ThreadManagerTest, TimerLoopsAreInterruptedByHandle) {
+    std::atomic<int> first_calls{0};
+    std::atomic<int> second_calls{0};
+    ThreadManager manager;
+    auto first = manager.add_timer_loop([&] { ++first_calls; }, 0.005);
+    auto second = manager.add_timer_loop([&] { ++second_calls; }, 0.005);
+    EXPECT_NE(first->get_handle_id(), second->get_handle_id());
+
+    // Both share the wheel thread, so its ID names neither of them.
+    manager.interrupt_thread(first->get_id());
+    EXPECT_TRUE(first->get_status());
+    EXPECT_TRUE(second->get_status());
+
+    manager.interrupt_handle(first->get_handle_id());
+    EXPECT_FALSE(first->get_status());
+    EXPECT_TRUE(second->get_status());
+    EXPECT_EQ(manager.get_timer_wheel().size(), 1u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    int paused = first_calls.load();
+    int running = second_calls.load();
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_EQ(first_calls.load(), paused);
+    EXPECT_GT(second_calls.load(), running);
+
+    first->set_status(true);
+    EXPECT_EQ(manager.get_timer_wheel().size(), 2u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_GT(first_calls.load(), paused);
+    manager.close();
+
+    // A handle that outlives the manager no longer touches the wheel.
+    first->set_status(true);
+}
+
+// A session script in the style of the coach: prompt, wait, repeat.
+static Task CountdownSession(ThreadManager* manager, int steps, double pause,
+                             std::vector<std::thread::id>* threads) {
+    for (int i = 0; i < steps; ++i) {
+        threads->push_back(std::this_thread::get_id());
+        co_await manager->delay(pause);
+    }
+}
+
+static Task WaitForValue(DataEvent<double>* event, double timeout, std::optional<double>* out) {
+    if (timeout > 0.0) {
+        *out = co_await event->next_for(timeout);
+    } else {
+        *out = co_await event->next();
+    }
+}
+
+static Task FailAfterDelay(ThreadManager* manager) {
+    co_await manager->delay(0.001);
+    throw std::runtime_error("session aborted");
+}
+
+class CoroutineTest : public ThreadManagerTest {};
+
+TEST_F(CoroutineTest, DelaysRunOnTheWheelThread) {
+    ThreadManager manager;
+    std::vector<std::thread::id> threads;
+
+    auto start = clock::now();
+    auto done = manager.spawn(CountdownSession(&manager, 3, 0.02, &threads));
+    ASSERT_EQ(done.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    done.get();
+
+    EXPECT_GE(clock::now() - start, std::chrono::milliseconds(60));
+    ASSERT_EQ(threads.size(), 3u);
+    for (auto id : threads) {
+        EXPECT_EQ(id, manager.get_timer_wheel().get_id());
+    }
+    manager.close();
+}
+
+TEST_F(CoroutineTest, ManySessionsWaitWithoutBlockingThreads) {
+    ThreadManager manager;
+    std::vector<std::vector<std::thread::id>> threads(200);
+    std::vector<std::future<void>> done;
+
+    auto start = clock::now();
+    for (auto& ids : threads) {
+        done.push_back(manager.spawn(CountdownSession(&manager, 2, 0.05, &ids)));
+    }
+    for (auto& future : done) {
+        ASSERT_EQ(future.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    }
+
+    // Sequential sleeping would take 200 * 0.1 s.
+    EXPECT_LT(clock::now() - start, std::chrono::seconds(1));
+    manager.close();
+}
+
+TEST_F(CoroutineTest, DataEventResumesWithPublishedValue) {
+    ThreadManager manager;
+    DataEvent<double> heart_rate(manager.get_timer_wheel());
+    std::optional<double> first, second;
+
+    auto a = manager.spawn(WaitForValue(&heart_rate, 0.0, &first));
+    auto b = manager.spawn(WaitForValue(&heart_rate, 1.0, &second));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    std::thread producer([&] { heart_rate.publish(72.5); });
+    producer.join();
+
+    ASSERT_EQ(a.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    ASSERT_EQ(b.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    EXPECT_EQ(first, 72.5);
+    EXPECT_EQ(second, 72.5);
+    manager.close();
+}
+
+TEST_F(CoroutineTest, DataEventTimesOut) {
+    ThreadManager manager;
+    DataEvent<double> heart_rate(manager.get_timer_wheel());
+    std::optional<double> value = 0.0;
+
+    auto start = clock::now();
+    auto done = manager.spawn(WaitForValue(&heart_rate, 0.03, &value));
+    ASSERT_EQ(done.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    EXPECT_GE(clock::now() - start, std::chrono::milliseconds(30));
+    EXPECT_FALSE(value.has_value());
+
+    // A late value must not touch the finished coroutine.
+    heart_rate.publish(80.0);
+    manager.close();
+}
+
+TEST_F(CoroutineTest, ExceptionsReachTheFuture) {
+    ThreadManager manager;
+    auto done = manager.spawn(FailAfterDelay(&manager));
+    ASSERT_EQ(done.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    EXPECT_THROW(done.get(), std::runtime_error);
+    manager.close();
+}
+
+TEST_F(CoroutineTest, CloseDestroysSuspendedSessions) {
+    ThreadManager manager;
+    std::vector<std::thread::id> threads;
+    auto done = manager.spawn(CountdownSession(&manager, 1, 60.0, &threads));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    manager.close();
+    ASSERT_EQ(done.wait_for(std::chrono::seconds(1)), std::future_status::ready);
+    EXPECT_THROW(done.get(), std::future_error);
+}